@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "checksum_trailer.hpp"
+#include "recording_family.hpp"
+#include "recording_header.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// Return the payload of a recording, with its checksum trailer and header
+/// verified and removed if it has them
+inline auto recording_payload(std::string_view recording)
+    -> tl::expected<std::string_view, std::string>
+{
+    auto content = verify_checksum_trailer(recording);
+    if (!content)
+    {
+        return content;
+    }
+    return verify_recording_header(*content);
+}
+
+/// Return the payload framed like the recording, i.e. with a header if the
+/// recording has one and with a checksum trailer if the recording has one
+inline auto frame_like(std::string_view payload, std::string_view recording)
+    -> std::string
+{
+    bool checksums = has_checksum_trailer(recording);
+    if (checksums)
+    {
+        recording = recording.substr(0, recording.size() -
+                                            checksum_trailer_size);
+    }
+
+    std::string output;
+    if (has_recording_header(recording))
+    {
+        append_recording_header(output, make_recording_header(payload));
+    }
+    output.append(payload.data(), payload.size());
+    if (checksums)
+    {
+        append_checksum_trailer(output);
+    }
+    return output;
+}
+
+/// Return the base recording of a variant "<base>.<variant>.delta" written
+/// by datarecorder::record_variant(), or nothing if the path is not a
+/// variant. A variant may contain dots, so the longest prefix naming an
+/// existing file is the base.
+inline auto variant_base(const std::filesystem::path& path)
+    -> std::optional<std::filesystem::path>
+{
+    std::string name = path.filename().string();
+    const std::string extension = ".delta";
+    if (name.size() <= extension.size() ||
+        name.compare(name.size() - extension.size(), extension.size(),
+                     extension) != 0)
+    {
+        return std::nullopt;
+    }
+    name.resize(name.size() - extension.size());
+
+    std::size_t dot = name.rfind('.');
+    while (dot != std::string::npos && dot != 0)
+    {
+        std::filesystem::path base = path.parent_path() / name.substr(0, dot);
+        if (std::filesystem::is_regular_file(base))
+        {
+            return base;
+        }
+        dot = name.rfind('.', dot - 1);
+    }
+    return std::nullopt;
+}
+
+/// Replace the recording with the data produced in a mismatch. The mismatch
+/// holds the produced data as it is, so it is encoded like the recorder
+/// would: a variant is stored as a delta against its base, and the header
+/// and the checksum trailer are added if the recording has them.
+///
+/// Returns an error if the base of a variant is corrupt, the recording is
+/// then left untouched.
+inline auto accept_mismatch(const std::filesystem::path& mismatch_path,
+                            const std::filesystem::path& recording_path)
+    -> tl::expected<void, std::string>
+{
+    std::string produced = read_binary_file(mismatch_path);
+    std::string recording = read_binary_file(recording_path);
+
+    std::string payload;
+    if (auto base_path = variant_base(recording_path))
+    {
+        std::string base_recording = read_binary_file(*base_path);
+        auto base = recording_payload(base_recording);
+        if (!base)
+        {
+            return tl::make_unexpected(base_path->string() + ": " +
+                                       base.error());
+        }
+        payload = encode_delta(*base, produced);
+    }
+    else
+    {
+        payload = std::move(produced);
+    }
+
+    write_file_atomic(recording_path, frame_like(payload, recording),
+                      std::ios::binary);
+    return {};
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "hash.hpp"
+#include "manifest.hpp"
+#include "parallel_for.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// Pack all files below the directory into a single archive. The files are
+/// read on threads threads, zero uses the number of hardware threads. The
+/// archive stores every file little-endian as:
+///
+///     "DRP1"
+///     per file: varint path size, the path relative to the directory with
+///               "/" separators, varint size, u64 FNV-1a hash, the content
+inline auto pack(const std::filesystem::path& dir, std::size_t threads = 0)
+    -> std::string
+{
+    std::vector<std::string> paths = list_recordings(dir);
+    std::vector<std::string> contents(paths.size());
+    parallel_for(paths.size(), threads, [&](std::size_t i)
+                 { contents[i] = read_binary_file(dir / paths[i]); });
+
+    std::string archive;
+    archive.append("DRP1", 4);
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        append_varint(archive, paths[i].size());
+        archive += paths[i];
+        append_varint(archive, contents[i].size());
+        append_le(archive, fnv1a_64(contents[i]));
+        archive += contents[i];
+    }
+    return archive;
+}
+
+/// Unpack an archive written by pack() into the directory. Every file is
+/// checked against its hash, and paths leaving the directory are rejected.
+/// Returns the number of files written.
+inline auto unpack(std::string_view archive, const std::filesystem::path& dir)
+    -> tl::expected<std::size_t, std::string>
+{
+    binary_reader reader(archive);
+    std::string_view magic;
+    if (!reader.read_bytes(4, magic) || magic != "DRP1")
+    {
+        return tl::make_unexpected(std::string{"not a recording archive"});
+    }
+
+    // Check the whole archive before writing anything
+    struct file
+    {
+        std::string_view path;
+        std::string_view content;
+    };
+    std::vector<file> files;
+    while (reader.remaining() > 0)
+    {
+        std::uint64_t path_size = 0;
+        std::uint64_t size = 0;
+        std::uint64_t hash = 0;
+        file f;
+        if (!reader.read_varint(path_size) ||
+            !reader.read_bytes(path_size, f.path) ||
+            !reader.read_varint(size) || !reader.read(hash) ||
+            !reader.read_bytes(size, f.content))
+        {
+            return tl::make_unexpected(std::string{"truncated archive"});
+        }
+
+        std::filesystem::path relative(std::string(f.path));
+        bool escapes = relative.empty() || relative.is_absolute() ||
+                       relative.has_root_name();
+        for (const auto& part : relative)
+        {
+            escapes = escapes || part == "..";
+        }
+        if (escapes)
+        {
+            return tl::make_unexpected("invalid path in archive: " +
+                                       std::string(f.path));
+        }
+        if (fnv1a_64(f.content) != hash)
+        {
+            return tl::make_unexpected("corrupt file in archive: " +
+                                       std::string(f.path));
+        }
+        files.push_back(f);
+    }
+
+    for (const auto& f : files)
+    {
+        write_binary_file(dir / std::string(f.path), f.content);
+    }
+    return files.size();
+}
+
+}
\ No newline at end of file
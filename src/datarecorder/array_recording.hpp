@@ -0,0 +1,325 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "comparator.hpp"
+#include "numeric_comparator.hpp"
+
+namespace datarecorder
+{
+
+/// The kind of the elements stored in an array recording
+enum class array_type : std::uint8_t
+{
+    signed_integer = 1,
+    unsigned_integer = 2,
+    floating_point = 3
+};
+
+/// The header of an array recording. The header and the elements are
+/// stored little-endian:
+///
+///     offset  size  field
+///     0       4     magic "DRA1"
+///     4       1     array_type
+///     5       1     element size in bytes
+///     6       2     reserved, zero
+///     8       8     number of elements
+///     16            the elements
+struct array_header
+{
+    array_type type;
+    std::uint8_t element_size;
+    std::uint64_t count;
+};
+
+/// The size of the array header in bytes
+constexpr std::size_t array_header_size = 16;
+
+/// Return the array type of T
+template <class T>
+constexpr auto array_type_of() -> array_type
+{
+    static_assert(std::is_arithmetic<T>::value &&
+                      !std::is_same<T, bool>::value && sizeof(T) <= 8,
+                  "Array recordings support arithmetic types up to 64 bits");
+
+    if (std::is_floating_point<T>::value)
+    {
+        return array_type::floating_point;
+    }
+    return std::is_signed<T>::value ? array_type::signed_integer
+                                    : array_type::unsigned_integer;
+}
+
+/// Return a readable name of the element type e.g. "float64"
+inline auto array_type_name(array_type type, std::size_t element_size)
+    -> std::string
+{
+    std::string name;
+    switch (type)
+    {
+    case array_type::signed_integer:
+        name = "int";
+        break;
+    case array_type::unsigned_integer:
+        name = "uint";
+        break;
+    case array_type::floating_point:
+        name = "float";
+        break;
+    default:
+        name = "unknown";
+    }
+    return name + std::to_string(element_size * 8);
+}
+
+/// Return the distance between two integers, exact for all 64 bit values
+template <class T>
+auto integer_distance(T a, T b) -> std::uint64_t
+{
+    static_assert(std::is_integral<T>::value, "T must be an integer");
+    auto x = static_cast<std::uint64_t>(a);
+    auto y = static_cast<std::uint64_t>(b);
+    return a > b ? x - y : y - x;
+}
+
+/// Return the absolute difference of the two elements
+template <class T>
+auto element_error(T a, T b) -> double
+{
+    if constexpr (std::is_integral<T>::value)
+    {
+        return static_cast<double>(integer_distance(a, b));
+    }
+    else
+    {
+        return std::fabs(static_cast<double>(a) - static_cast<double>(b));
+    }
+}
+
+/// Return the element as text that parses back to the same value
+template <class T>
+auto element_string(T value) -> std::string
+{
+    if constexpr (std::is_integral<T>::value)
+    {
+        return std::to_string(value);
+    }
+    else
+    {
+        return to_string_exact(static_cast<double>(value));
+    }
+}
+
+/// Return true if the two elements are equal within the tolerance. The ULP
+/// distance is measured in the precision of T, it is ignored for integers.
+/// Integers are compared exactly, converting them to double would make
+/// values above 2^53 that differ equal.
+template <class T>
+auto within_tolerance(T a, T b, const tolerance& tolerance) -> bool
+{
+    if constexpr (std::is_integral<T>::value)
+    {
+        if (a == b)
+        {
+            return true;
+        }
+        std::uint64_t difference = integer_distance(a, b);
+
+        // 2^64, every distance is within an absolute tolerance this large
+        constexpr double limit = 18446744073709551616.0;
+        if (tolerance.absolute >= limit ||
+            (tolerance.absolute >= 1.0 &&
+             difference <= static_cast<std::uint64_t>(tolerance.absolute)))
+        {
+            return true;
+        }
+        double magnitude = std::max(std::fabs(static_cast<double>(a)),
+                                    std::fabs(static_cast<double>(b)));
+        return tolerance.relative > 0.0 && static_cast<double>(difference) <=
+                                               tolerance.relative * magnitude;
+    }
+    else
+    {
+        struct tolerance without_ulps = tolerance;
+        without_ulps.ulps = 0;
+        if (within_tolerance(static_cast<double>(a), static_cast<double>(b),
+                             without_ulps))
+        {
+            return true;
+        }
+        return ulp_distance(a, b) <= tolerance.ulps;
+    }
+}
+
+/// Encode the values as an array recording
+template <class T>
+auto encode_array(const T* values, std::size_t count) -> std::string
+{
+    std::string output;
+    output.reserve(array_header_size + count * sizeof(T));
+    output.append("DRA1", 4);
+    append_le(output, static_cast<std::uint8_t>(array_type_of<T>()));
+    append_le(output, static_cast<std::uint8_t>(sizeof(T)));
+    append_le(output, std::uint16_t{0});
+    append_le(output, static_cast<std::uint64_t>(count));
+    append_le(output, values, count);
+    return output;
+}
+
+/// Decode the header of an array recording
+inline auto decode_array_header(std::string_view data)
+    -> tl::expected<array_header, std::string>
+{
+    if (data.size() < array_header_size || data.substr(0, 4) != "DRA1")
+    {
+        return tl::make_unexpected(std::string{"not an array recording"});
+    }
+
+    array_header header;
+    header.type = static_cast<array_type>(read_le<std::uint8_t>(data, 4));
+    header.element_size = read_le<std::uint8_t>(data, 5);
+    header.count = read_le<std::uint64_t>(data, 8);
+
+    if (header.element_size == 0 ||
+        (data.size() - array_header_size) / header.element_size !=
+            header.count ||
+        (data.size() - array_header_size) % header.element_size != 0)
+    {
+        return tl::make_unexpected(
+            std::string{"array recording size does not match its header"});
+    }
+    return header;
+}
+
+/// Decode the elements of an array recording of T
+template <class T>
+auto decode_array(std::string_view data)
+    -> tl::expected<std::vector<T>, std::string>
+{
+    auto header = decode_array_header(data);
+    if (!header)
+    {
+        return tl::make_unexpected(header.error());
+    }
+    if (header->type != array_type_of<T>() ||
+        header->element_size != sizeof(T))
+    {
+        return tl::make_unexpected(
+            "array recording has type " +
+            array_type_name(header->type, header->element_size) +
+            " instead of " + array_type_name(array_type_of<T>(), sizeof(T)));
+    }
+
+    std::vector<T> values(header->count);
+    read_le(data, array_header_size, values.data(), values.size());
+    return values;
+}
+
+/// Return a comparator for array recordings of T. The elements are compared
+/// under the tolerance, and on a mismatch the description holds the index
+/// of the worst deviation and the error statistics of the whole array.
+///
+/// Identical arrays are detected with a single memcmp. Otherwise a first
+/// pass sums the errors for the statistics, and a second pass checks every
+/// element that is not bitwise equal with within_tolerance(). The error of
+/// an element is only computed again when it is beyond the tolerance.
+template <class T>
+auto array_comparator(tolerance tolerance) -> comparator
+{
+    return [tolerance](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        auto produced = decode_array<T>(data);
+        if (!produced)
+        {
+            return tl::make_unexpected("produced " + produced.error());
+        }
+        auto recorded = decode_array<T>(recording);
+        if (!recorded)
+        {
+            return tl::make_unexpected(recorded.error());
+        }
+        if (produced->size() != recorded->size())
+        {
+            return tl::make_unexpected(
+                "array has " + std::to_string(produced->size()) +
+                " elements, the recording has " +
+                std::to_string(recorded->size()));
+        }
+
+        const std::size_t count = produced->size();
+        const T* a = produced->data();
+        const T* b = recorded->data();
+
+        // The error statistics of the whole array
+        double sum = 0.0;
+        double sum_of_squares = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            double error = element_error(a[i], b[i]);
+            sum += error;
+            sum_of_squares += error * error;
+        }
+
+        // The elements beyond the tolerance
+        std::size_t violations = 0;
+        std::size_t worst = count;
+        double worst_error = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // NaNs with the same bits are equal
+            if (std::memcmp(&a[i], &b[i], sizeof(T)) == 0 ||
+                within_tolerance(a[i], b[i], tolerance))
+            {
+                continue;
+            }
+            ++violations;
+            double error = element_error(a[i], b[i]);
+            if (worst == count || !(error <= worst_error))
+            {
+                worst = i;
+                worst_error = error;
+            }
+        }
+
+        if (violations == 0)
+        {
+            return {};
+        }
+
+        return tl::make_unexpected(
+            "element " + std::to_string(worst) + " deviates most, it is " +
+            element_string(a[worst]) + " and the recording has " +
+            element_string(b[worst]) + "; " +
+            std::to_string(violations) + " of " + std::to_string(count) +
+            " elements beyond the tolerance, worst error " +
+            std::to_string(worst_error) + ", mean error " +
+            std::to_string(sum / count) + ", rms error " +
+            std::to_string(std::sqrt(sum_of_squares / count)));
+    };
+}
+
+}
\ No newline at end of file
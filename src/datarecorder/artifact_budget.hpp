@@ -0,0 +1,159 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+namespace datarecorder
+{
+
+/// Limits the number of mismatch artifact sets and the total number of bytes
+/// written for them by a process. Once the budget is spent the mismatch
+/// handlers only return a summary, so a run where every test mismatches
+/// cannot fill the disk.
+///
+/// The defaults are 256 artifact sets and 512 MiB. They can be changed with
+/// set_limits() or the DATARECORDER_MAX_ARTIFACTS and
+/// DATARECORDER_MAX_ARTIFACT_BYTES environment variables.
+///
+/// The process-wide budget reports its counters on stderr at exit if any
+/// artifacts were written or suppressed.
+class artifact_budget
+{
+public:
+    /// The process-wide budget
+    static auto instance() -> artifact_budget&
+    {
+        static artifact_budget instance(true);
+        return instance;
+    }
+
+    /// Constructor
+    explicit artifact_budget(bool report_at_exit = false) :
+        m_report_at_exit(report_at_exit)
+    {
+        if (const char* sets = std::getenv("DATARECORDER_MAX_ARTIFACTS"))
+        {
+            m_max_sets = std::strtoull(sets, nullptr, 10);
+        }
+        if (const char* bytes = std::getenv("DATARECORDER_MAX_ARTIFACT_BYTES"))
+        {
+            m_max_bytes = std::strtoull(bytes, nullptr, 10);
+        }
+    }
+
+    /// Destructor
+    ~artifact_budget()
+    {
+        if (m_report_at_exit && (m_sets > 0 || m_suppressed > 0))
+        {
+            std::fprintf(stderr, "%s\n", report().c_str());
+        }
+    }
+
+    artifact_budget(const artifact_budget&) = delete;
+    artifact_budget& operator=(const artifact_budget&) = delete;
+
+    /// Set the maximum number of artifact sets and bytes
+    void set_limits(std::size_t max_sets, std::uint64_t max_bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_sets = max_sets;
+        m_max_bytes = max_bytes;
+    }
+
+    /// Reserve an artifact set of the given size. Returns false and counts
+    /// the set as suppressed if it does not fit in the budget.
+    auto reserve(std::uint64_t bytes) -> bool
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_sets + 1 > m_max_sets || m_bytes + bytes > m_max_bytes)
+        {
+            ++m_suppressed;
+            return false;
+        }
+
+        ++m_sets;
+        m_bytes += bytes;
+        return true;
+    }
+
+    /// Return a one line summary of the counters
+    auto report() const -> std::string
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return "datarecorder: " + std::to_string(m_sets) +
+               " mismatch artifact set(s) written (" + std::to_string(m_bytes) +
+               " bytes), " + std::to_string(m_suppressed) +
+               " suppressed by the artifact budget (" +
+               std::to_string(m_max_sets) + " sets, " +
+               std::to_string(m_max_bytes) + " bytes)";
+    }
+
+    /// The maximum number of artifact sets
+    auto max_sets() const -> std::size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_max_sets;
+    }
+
+    /// The maximum number of bytes
+    auto max_bytes() const -> std::uint64_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_max_bytes;
+    }
+
+    /// The number of artifact sets written
+    auto sets() const -> std::size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_sets;
+    }
+
+    /// The number of bytes written
+    auto bytes() const -> std::uint64_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes;
+    }
+
+    /// The number of artifact sets suppressed
+    auto suppressed() const -> std::size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_suppressed;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+
+    bool m_report_at_exit;
+
+    std::size_t m_max_sets = 256;
+    std::uint64_t m_max_bytes = 512ULL * 1024 * 1024;
+
+    std::size_t m_sets = 0;
+    std::uint64_t m_bytes = 0;
+    std::size_t m_suppressed = 0;
+};
+
+/// Set the budget for mismatch artifacts written by this process, i.e. the
+/// limits of artifact_budget::instance(). Mismatches beyond the budget are
+/// reported with a summary only.
+inline void set_artifact_budget(std::size_t max_artifact_sets,
+                                std::uint64_t max_bytes)
+{
+    artifact_budget::instance().set_limits(max_artifact_sets, max_bytes);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace datarecorder
+{
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) &&                             \
+                        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+/// True if the host is little-endian, binary recordings are stored
+/// little-endian so then values can be copied as is
+constexpr bool host_is_little_endian = true;
+#else
+constexpr bool host_is_little_endian = false;
+#endif
+
+/// Return the unsigned integer type with the same size as T
+template <class T>
+using uint_of_size = std::conditional_t<
+    sizeof(T) == 1, std::uint8_t,
+    std::conditional_t<
+        sizeof(T) == 2, std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+/// Append the arithmetic value to the output in little-endian byte order
+template <class T>
+void append_le(std::string& output, T value)
+{
+    static_assert(std::is_arithmetic<T>::value, "Arithmetic types only");
+
+    uint_of_size<T> bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        output += static_cast<char>((bits >> (8 * i)) & 0xff);
+    }
+}
+
+/// Read an arithmetic value stored in little-endian byte order at the
+/// offset. The caller must check that the data is large enough.
+template <class T>
+auto read_le(std::string_view data, std::size_t offset) -> T
+{
+    static_assert(std::is_arithmetic<T>::value, "Arithmetic types only");
+
+    uint_of_size<T> bits = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        bits |= static_cast<uint_of_size<T>>(
+                    static_cast<unsigned char>(data[offset + i]))
+                << (8 * i);
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+/// Append the values to the output in little-endian byte order
+template <class T>
+void append_le(std::string& output, const T* values, std::size_t count)
+{
+    if (host_is_little_endian)
+    {
+        output.append(reinterpret_cast<const char*>(values),
+                      count * sizeof(T));
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        append_le(output, values[i]);
+    }
+}
+
+/// Read count values stored in little-endian byte order at the offset
+template <class T>
+void read_le(std::string_view data, std::size_t offset, T* values,
+             std::size_t count)
+{
+    if (host_is_little_endian)
+    {
+        std::memcpy(values, data.data() + offset, count * sizeof(T));
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        values[i] = read_le<T>(data, offset + i * sizeof(T));
+    }
+}
+
+/// Append the value as a LEB128 variable length integer, 7 bits per byte
+/// with the high bit set on all but the last byte
+inline void append_varint(std::string& output, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        output += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    output += static_cast<char>(value);
+}
+
+/// Reads little-endian values from binary data with bounds checks. A read
+/// past the end fails and leaves the reader at the end, so a sequence of
+/// reads can be checked once with ok().
+class binary_reader
+{
+public:
+    /// Constructor
+    explicit binary_reader(std::string_view data) : m_data(data)
+    {
+    }
+
+    /// Read an arithmetic value
+    template <class T>
+    auto read(T& value) -> bool
+    {
+        if (!check(sizeof(T)))
+        {
+            return false;
+        }
+        value = read_le<T>(m_data, m_offset);
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    /// Read a variable length integer written with append_varint()
+    auto read_varint(std::uint64_t& value) -> bool
+    {
+        value = 0;
+        for (std::size_t shift = 0; shift < 64; shift += 7)
+        {
+            std::uint8_t byte = 0;
+            if (!read(byte))
+            {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        // More than 10 bytes is not a valid varint
+        m_ok = false;
+        m_offset = m_data.size();
+        return false;
+    }
+
+    /// Read the next size bytes
+    auto read_bytes(std::size_t size, std::string_view& bytes) -> bool
+    {
+        if (!check(size))
+        {
+            return false;
+        }
+        bytes = m_data.substr(m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    /// The number of bytes not read yet
+    auto remaining() const -> std::size_t
+    {
+        return m_data.size() - m_offset;
+    }
+
+    /// The number of bytes read
+    auto offset() const -> std::size_t
+    {
+        return m_offset;
+    }
+
+    /// Return true if no read failed
+    auto ok() const -> bool
+    {
+        return m_ok;
+    }
+
+private:
+    auto check(std::size_t size) -> bool
+    {
+        if (!m_ok || size > remaining())
+        {
+            m_ok = false;
+            m_offset = m_data.size();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string_view m_data;
+    std::size_t m_offset = 0;
+    bool m_ok = true;
+};
+
+}
\ No newline at end of file
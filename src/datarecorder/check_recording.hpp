@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "array_recording.hpp"
+#include "checksum_trailer.hpp"
+#include "event_log.hpp"
+#include "recording_header.hpp"
+#include "table_recording.hpp"
+
+namespace datarecorder
+{
+
+/// Check the structure of a recording. The checksum trailer and the header
+/// are verified if the recording has them. Array, table and event log
+/// recordings are recognized by their magic and decoded, other recordings
+/// are accepted as they are.
+inline auto check_recording(std::string_view data)
+    -> tl::expected<void, std::string>
+{
+    auto content = verify_checksum_trailer(data);
+    if (!content)
+    {
+        return tl::make_unexpected(content.error());
+    }
+    data = *content;
+
+    // The header must match the payload, which is then checked like a
+    // recording without header
+    content = verify_recording_header(data);
+    if (!content)
+    {
+        return tl::make_unexpected(content.error());
+    }
+    if (has_recording_header(data) &&
+        decode_recording_header(data)->format != detect_format(*content))
+    {
+        return tl::make_unexpected(
+            std::string("the payload does not match the format in the header"));
+    }
+    data = *content;
+
+    std::string_view magic = data.substr(0, 4);
+    if (magic == "DRA1")
+    {
+        auto header = decode_array_header(data);
+        if (!header)
+        {
+            return tl::make_unexpected(header.error());
+        }
+    }
+    else if (magic == "DRT1")
+    {
+        auto table = decode_table(data);
+        if (!table)
+        {
+            return tl::make_unexpected(table.error());
+        }
+    }
+    else if (magic == "DRE1")
+    {
+        auto events =
+            for_each_event(data, [](const event_view&) { return true; });
+        if (!events)
+        {
+            return tl::make_unexpected(events.error());
+        }
+    }
+    return {};
+}
+
+}
\ No newline at end of file
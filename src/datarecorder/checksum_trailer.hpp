@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "crc32c.hpp"
+
+namespace datarecorder
+{
+
+/// The size of the checksum trailer. The trailer holds the size of the
+/// content as u64, its CRC-32C as u32 and the magic "DRC1", little-endian.
+constexpr std::size_t checksum_trailer_size = 16;
+
+/// Append the checksum trailer of the content to it
+template <class String>
+void append_checksum_trailer(String& content)
+{
+    std::string trailer;
+    append_le(trailer, std::uint64_t{content.size()});
+    append_le(trailer, crc32c(content));
+    trailer += "DRC1";
+    content.append(trailer.data(), trailer.size());
+}
+
+/// Return true if the data ends with a checksum trailer
+inline auto has_checksum_trailer(std::string_view data) -> bool
+{
+    if (data.size() < checksum_trailer_size ||
+        data.substr(data.size() - 4) != "DRC1")
+    {
+        return false;
+    }
+    std::size_t content_size = data.size() - checksum_trailer_size;
+    return read_le<std::uint64_t>(data, content_size) == content_size;
+}
+
+/// Verify the checksum trailer of the data and return the content without
+/// the trailer. Data without a trailer is returned as it is.
+inline auto verify_checksum_trailer(std::string_view data)
+    -> tl::expected<std::string_view, std::string>
+{
+    if (!has_checksum_trailer(data))
+    {
+        return data;
+    }
+
+    std::string_view content =
+        data.substr(0, data.size() - checksum_trailer_size);
+    std::uint32_t expected = read_le<std::uint32_t>(data, content.size() + 8);
+    std::uint32_t actual = crc32c(content);
+    if (actual != expected)
+    {
+        char message[128];
+        std::snprintf(message, sizeof(message),
+                      "checksum mismatch, the content has CRC-32C %08x but "
+                      "the trailer %08x",
+                      static_cast<unsigned>(actual),
+                      static_cast<unsigned>(expected));
+        return tl::make_unexpected(std::string(message));
+    }
+    return content;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+namespace datarecorder
+{
+
+/// A comparator checks the produced data against the recording. It returns
+/// nothing if the data matches, otherwise a description of the difference
+/// which is passed to the mismatch handler in mismatch_info::description.
+///
+/// Example:
+///     recorder.set_comparator(
+///         [](std::string_view data, std::string_view recording)
+///             -> tl::expected<void, std::string>
+///         {
+///             if (data.size() != recording.size())
+///             {
+///                 return tl::make_unexpected("size differs");
+///             }
+///             return {};
+///         });
+using comparator = std::function<tl::expected<void, std::string>(
+    std::string_view data, std::string_view recording)>;
+
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "binary_format.hpp"
+
+// The CRC instructions are used where the compiler can target them, define
+// DATARECORDER_DISABLE_CRC32C_INTRINSICS to always use the table
+#if !defined(DATARECORDER_DISABLE_CRC32C_INTRINSICS)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define DATARECORDER_CRC32C_SSE42 1
+#include <nmmintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define DATARECORDER_CRC32C_SSE42 1
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define DATARECORDER_CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+#endif
+
+namespace datarecorder
+{
+
+/// Return the tables of the slicing-by-8 CRC-32C, table k holds the CRC of
+/// a byte followed by k zero bytes
+constexpr auto make_crc32c_tables()
+    -> std::array<std::array<std::uint32_t, 256>, 8>
+{
+    // The reversed Castagnoli polynomial
+    constexpr std::uint32_t polynomial = 0x82f63b78;
+
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t i = 0; i < 256; ++i)
+    {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (std::size_t k = 1; k < 8; ++k)
+    {
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t previous = tables[k - 1][i];
+            tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+    }
+    return tables;
+}
+
+/// Compute the CRC-32C of the data with tables, eight bytes per step. Pass a
+/// previous CRC to continue from it.
+inline auto crc32c_table(std::string_view data, std::uint32_t crc = 0)
+    -> std::uint32_t
+{
+    static constexpr auto tables = make_crc32c_tables();
+
+    crc = ~crc;
+    std::size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8)
+    {
+        std::uint64_t word = read_le<std::uint64_t>(data, i) ^ crc;
+        crc = tables[7][word & 0xff] ^ tables[6][(word >> 8) & 0xff] ^
+              tables[5][(word >> 16) & 0xff] ^ tables[4][(word >> 24) & 0xff] ^
+              tables[3][(word >> 32) & 0xff] ^ tables[2][(word >> 40) & 0xff] ^
+              tables[1][(word >> 48) & 0xff] ^ tables[0][word >> 56];
+    }
+    for (; i < data.size(); ++i)
+    {
+        crc = (crc >> 8) ^
+              tables[0][(crc ^ static_cast<unsigned char>(data[i])) & 0xff];
+    }
+    return ~crc;
+}
+
+#if defined(DATARECORDER_CRC32C_SSE42)
+
+/// Return true if the CPU has the SSE4.2 CRC instruction
+inline auto crc32c_hardware_available() -> bool
+{
+#if defined(_MSC_VER)
+    static const bool available = []
+    {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+    }();
+#else
+    static const bool available = __builtin_cpu_supports("sse4.2");
+#endif
+    return available;
+}
+
+/// Compute the CRC-32C of the data with the SSE4.2 CRC instruction. Must
+/// only be called if crc32c_hardware_available().
+#if !defined(_MSC_VER)
+__attribute__((target("sse4.2")))
+#endif
+inline auto crc32c_hardware(std::string_view data, std::uint32_t crc = 0)
+    -> std::uint32_t
+{
+    std::uint64_t state = ~crc;
+    const char* p = data.data();
+    std::size_t size = data.size();
+    for (; size >= 8; p += 8, size -= 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        state = _mm_crc32_u64(state, word);
+    }
+    auto state32 = static_cast<std::uint32_t>(state);
+    for (; size > 0; ++p, --size)
+    {
+        state32 = _mm_crc32_u8(state32, static_cast<unsigned char>(*p));
+    }
+    return ~state32;
+}
+
+#elif defined(DATARECORDER_CRC32C_ARMV8)
+
+/// Return true if the CPU has the ARMv8 CRC instructions, which the
+/// compiler was told it may assume
+inline auto crc32c_hardware_available() -> bool
+{
+    return true;
+}
+
+/// Compute the CRC-32C of the data with the ARMv8 CRC instructions
+inline auto crc32c_hardware(std::string_view data, std::uint32_t crc = 0)
+    -> std::uint32_t
+{
+    crc = ~crc;
+    const char* p = data.data();
+    std::size_t size = data.size();
+    for (; size >= 8; p += 8, size -= 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; ++p, --size)
+    {
+        crc = __crc32cb(crc, static_cast<unsigned char>(*p));
+    }
+    return ~crc;
+}
+
+#else
+
+/// Return true if CRC instructions are available, never on this target
+inline auto crc32c_hardware_available() -> bool
+{
+    return false;
+}
+
+/// Without CRC instructions the tables are used
+inline auto crc32c_hardware(std::string_view data, std::uint32_t crc = 0)
+    -> std::uint32_t
+{
+    return crc32c_table(data, crc);
+}
+
+#endif
+
+/// Compute the CRC-32C (Castagnoli) of the data, with the CRC instructions
+/// of SSE4.2 or ARMv8 if available and otherwise with tables. Pass a
+/// previous CRC to continue from it.
+inline auto crc32c(std::string_view data, std::uint32_t crc = 0)
+    -> std::uint32_t
+{
+    if (crc32c_hardware_available())
+    {
+        return crc32c_hardware(data, crc);
+    }
+    return crc32c_table(data, crc);
+}
+
+}
\ No newline at end of file
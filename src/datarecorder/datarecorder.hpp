@@ -5,22 +5,56 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <memory_resource>
 #include <optional>
-#include <regex>
 #include <string>
 #include <vector>
 
-#include <gtest/gtest.h>
 #include <poke/make_error.hpp>
 #include <poke/monitor.hpp>
 #include <tl/expected.hpp>
 #include <verify/verify.hpp>
 
+#include "array_recording.hpp"
+#include "artifact_budget.hpp"
+#include "checksum_trailer.hpp"
+#include "comparator.hpp"
+#include "determinism_probe.hpp"
+#include "diff.hpp"
+#include "event_log.hpp"
+#include "hunk_viewer.hpp"
+#include "json_string.hpp"
+#include "keyed_lines_comparator.hpp"
 #include "mismatch_info.hpp"
+#include "mismatch_registry.hpp"
+#include "name_provider.hpp"
+#include "normalizer.hpp"
+#include "numeric_comparator.hpp"
+#include "recording_family.hpp"
+#include "recording_header.hpp"
+#include "scoped_arena.hpp"
+#include "session.hpp"
+#include "storage.hpp"
+#include "table_recording.hpp"
 #include "to_json_property.hpp"
+#include "unordered_lines_comparator.hpp"
+#include "usage_journal.hpp"
+#include "visualizer_template.hpp"
+#include "whitespace_comparator.hpp"
+
+// Define DATARECORDER_DISABLE_GTEST to use the recorder without Google Test,
+// recording filenames are then only derived from a name_provider. The define
+// must be the same in all translation units of a program.
+#if !defined(DATARECORDER_DISABLE_GTEST)
+#include "gtest_name_provider.hpp"
+#endif
 
 namespace datarecorder
 {
@@ -108,8 +142,7 @@ public:
     }
 
     /// Set the recording filename. If not set the filename will be derived
-    /// from the current test name (assuming this is used in a Google Test
-    /// environment).
+    /// from the current test name on every record, see set_name_provider().
     void set_recording_filename(std::string filename)
     {
         // The file extension should be 2 or more characters ".something"
@@ -117,6 +150,19 @@ public:
                filename);
 
         m_recording_filename = filename;
+        m_derived_filename = false;
+    }
+
+    /// Set the name provider used to derive the recording filename if it
+    /// is not set, see name_provider. Without a name provider the name of
+    /// the innermost scoped_name on the calling thread is used, and then
+    /// the name of the running Google Test test.
+    ///
+    /// Example:
+    ///     recorder.set_name_provider(datarecorder::explicit_name("canary"));
+    void set_name_provider(name_provider provider)
+    {
+        m_name_provider = std::move(provider);
     }
 
     /// Set the callback that will be called when a mismatch is found.
@@ -145,10 +191,438 @@ public:
         m_on_mismatch = callback;
     }
 
+    /// Set the comparator used to check the data against the recording,
+    /// see comparator. By default the data must equal the recording.
+    ///
+    /// Example:
+    ///     datarecorder::tolerance tolerance;
+    ///     tolerance.relative = 1e-12;
+    ///     recorder.set_comparator(
+    ///         datarecorder::numeric_comparator(tolerance));
+    void set_comparator(comparator comparator)
+    {
+        m_comparator = std::move(comparator);
+    }
+
+    /// Set the normalizer applied to the data before it is compared with or
+    /// stored as a recording. When comparing, the normalized data is
+    /// checked piece by piece against the recording without building a
+    /// normalized copy, a copy is only made if there is a mismatch.
+    void set_normalizer(normalizer normalizer)
+    {
+        m_normalizer = std::move(normalizer);
+    }
+
+    /// Set the maximum combined size in bytes of the recording and the
+    /// produced data that the diff visualizer will inline in its HTML page.
+    /// Larger mismatches are only written as precomputed hunks viewed with
+    /// the recording_hunks.html page. Default is 1 MiB.
+    void set_inline_diff_limit(std::size_t bytes)
+    {
+        m_inline_diff_limit = bytes;
+    }
+
+    /// Keep the fingerprints of mismatches in /tmp/cppmismatch-cache, such
+    /// that a mismatch identical to one seen in an earlier run points at
+    /// the existing artifacts instead of writing new ones. Within a process
+    /// identical mismatches are always only written once.
+    void enable_mismatch_cache()
+    {
+        mismatch_registry::instance().enable_cache();
+    }
+
+    /// Write new recordings with a self-describing header holding the
+    /// format, size and hash of the payload, see recording_header.
+    ///
+    /// Headers are detected when a recording is read, whether enabled or
+    /// not. If a recording has a header and no comparator is set, data of
+    /// a different size or format is reported as a mismatch from the header
+    /// alone, without reading the payload; the mismatch then holds no
+    /// recording data. A match is always decided on the payload, after the
+    /// header and the checksum trailer are verified.
+    void enable_recording_header()
+    {
+        m_header = true;
+    }
+
+    /// Write new recordings with a checksum trailer holding their CRC-32C,
+    /// see append_checksum_trailer(), and require it on existing ones.
+    ///
+    /// The trailer of a recording is always verified when the recording is
+    /// read, with the CRC instructions of the CPU where available. A
+    /// recording that fails the check is reported as corrupt instead of
+    /// being passed to the mismatch handler.
+    void enable_checksums()
+    {
+        m_checksums = true;
+    }
+
+    /// Set the memory resource the buffers of the recorder are allocated
+    /// from, such as the recording read from disk, the normalized data and
+    /// the joined lines of a vector. Without a memory resource the innermost
+    /// scoped_arena of the calling thread is used, or else the default
+    /// memory resource.
+    ///
+    /// The memory resource must outlive the recorder.
+    void set_memory_resource(std::pmr::memory_resource* resource)
+    {
+        m_memory_resource = resource;
+    }
+
+    /// Append the recordings this recorder uses to the journal, see
+    /// usage_journal. Without a journal the process-wide journal is used
+    /// if the DATARECORDER_JOURNAL environment variable is set.
+    ///
+    /// The journal must outlive the recorder.
+    void set_usage_journal(usage_journal& journal)
+    {
+        m_usage_journal = &journal;
+    }
+
+    /// Collect mismatches in the process-wide session, see session. A single
+    /// index page and data bundle is written for all mismatches when the
+    /// process exits.
+    void use_session()
+    {
+        m_on_mismatch = [this](mismatch_info mismatch)
+        {
+            // Call the session handler
+            return session_mismatch_handler(mismatch);
+        };
+    }
+
     /// This is the base function that will record the data. Other convenience
     /// functions will call this function. But, before they must serialize their
     /// data to a single string.
-    auto record(const std::string& data) -> tl::expected<void, poke::error>
+    auto record(std::string_view data) -> tl::expected<void, poke::error>
+    {
+        std::filesystem::path recording_path = prepare_recording_path();
+
+        // If the recording does not exist we create it, unless another
+        // process creates it first in which case we compare with it
+        if (!std::filesystem::exists(recording_path))
+        {
+            m_monitor.log(
+                poke::log_level::debug,
+                poke::log::str{"message", "Recording file does not exist"},
+                poke::log::str{"path", recording_path.string()});
+
+            std::pmr::string buffer(memory_resource());
+            std::string_view recording_data = normalize(data, buffer);
+            if (create_recording(recording_path, recording_data))
+            {
+                return {};
+            }
+        }
+
+        m_monitor.log(
+            poke::log_level::debug,
+            poke::log::str{"message", "Recording file already exists"},
+            poke::log::str{"path", recording_path.string()});
+
+        // The header of the recording may show a mismatch in size or format
+        // without comparing the data. The payload is still read and verified,
+        // such that a corrupt recording is an error and the mismatch holds
+        // the recorded data.
+        std::optional<std::string> header_mismatch;
+        if (!m_comparator)
+        {
+            header_mismatch = compare_header(recording_path, data);
+        }
+
+        // Read the data from the recording path
+        auto loaded = load_recording(recording_path);
+        if (!loaded)
+        {
+            return tl::make_unexpected(loaded.error());
+        }
+        const std::pmr::string& recording_data = *loaded;
+
+        if (header_mismatch)
+        {
+            std::pmr::string buffer(memory_resource());
+            return report_mismatch(normalize(data, buffer), recording_data,
+                                   *header_mismatch);
+        }
+
+        if (m_normalizer)
+        {
+            if (!m_comparator && m_normalizer->equal(data, recording_data))
+            {
+                m_monitor.log(poke::log_level::debug,
+                              poke::log::str{"message", "No mismatch found"});
+                return {};
+            }
+
+            // Compare the data
+            std::pmr::string buffer(memory_resource());
+            return compare_data(normalize(data, buffer), recording_data);
+        }
+
+        // Compare the data
+        return compare_data(data, recording_data);
+    }
+
+    /// Record the output of the producer. If there is no recording yet, the
+    /// producer is run the given number of times on parallel threads and
+    /// the recording is only created if all runs agree, so nondeterministic
+    /// output is caught when the recording is created instead of later as
+    /// a flaky test, see probe_determinism(). If the recording exists the
+    /// producer runs once.
+    ///
+    /// Example:
+    ///     recorder.record_deterministic([] { return simulate(42); });
+    auto record_deterministic(const std::function<std::string()>& producer,
+                              std::size_t runs = 4)
+        -> tl::expected<void, poke::error>
+    {
+        std::filesystem::path recording_path = prepare_recording_path();
+        if (std::filesystem::exists(recording_path))
+        {
+            return record(producer());
+        }
+
+        auto output = probe_determinism(producer, runs);
+        if (!output)
+        {
+            m_monitor.log(poke::log_level::debug,
+                          poke::log::str{"message", "Nondeterministic output"},
+                          poke::log::str{"description", output.error()});
+
+            return tl::make_unexpected(poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"message",
+                               "Nondeterministic output, not recorded"},
+                poke::log::str{"recording_path:", recording_path.string()},
+                poke::log::str{"description:", output.error()}));
+        }
+        return record(*output);
+    }
+
+    /// Record an array of numbers. The array is stored as a binary column
+    /// with a typed header, see encode_array(), and compared element by
+    /// element under the tolerance. On a mismatch the description holds the
+    /// index of the worst deviation and the error statistics.
+    ///
+    /// The comparator and normalizer set on the recorder are not used.
+    ///
+    /// Example:
+    ///     std::vector<double> samples = channel.run();
+    ///     datarecorder::tolerance tolerance;
+    ///     tolerance.absolute = 1e-9;
+    ///     recorder.record_array(samples.data(), samples.size(), tolerance);
+    template <class T>
+    auto record_array(const T* data, std::size_t size,
+                      tolerance tolerance = {})
+        -> tl::expected<void, poke::error>
+    {
+        return record_binary(encode_array(data, size),
+                             array_comparator<T>(tolerance));
+    }
+
+    /// Convenience function to record a vector of numbers
+    template <class T>
+    auto record_array(const std::vector<T>& data, tolerance tolerance = {})
+        -> tl::expected<void, poke::error>
+    {
+        return record_array(data.data(), data.size(), tolerance);
+    }
+
+    /// Record a table. The table is stored column by column, see
+    /// encode_table(), and compared column by column using the tolerances
+    /// of the schema. On a mismatch the description holds the (row, column)
+    /// of the first differing cell of every differing column.
+    ///
+    /// The comparator and normalizer set on the recorder are not used.
+    auto record_table(const table& table) -> tl::expected<void, poke::error>
+    {
+        return record_binary(encode_table(table),
+                             table_comparator(table.schema()));
+    }
+
+    /// Record a variant of a recording family, such as one point of a
+    /// parameter sweep. The first recorded variant becomes the base of the
+    /// family and is stored as the recording. Every variant is stored as a
+    /// compact delta against the base next to it, named
+    /// "<recording>.<variant>.delta", see encode_delta().
+    ///
+    /// Without a comparator the data is compared with the base and delta
+    /// directly, the recorded variant is only built if there is a mismatch.
+    ///
+    /// Example:
+    ///     for (auto rate : {0.25, 0.5, 0.75})
+    ///     {
+    ///         recorder.record_variant("rate_" + std::to_string(rate),
+    ///                                 simulate(rate));
+    ///     }
+    auto record_variant(const std::string& variant, const std::string& data)
+        -> tl::expected<void, poke::error>
+    {
+        VERIFY(!variant.empty() &&
+                   variant.find_first_of("/\\") == std::string::npos,
+               "Variant must be a non-empty file name", variant);
+
+        std::filesystem::path base_path = prepare_recording_path();
+        std::filesystem::path delta_path = base_path;
+        delta_path += "." + variant + ".delta";
+
+        std::pmr::string buffer(memory_resource());
+        std::string_view produced = normalize(data, buffer);
+
+        bool created = false;
+        if (!std::filesystem::exists(base_path))
+        {
+            m_monitor.log(
+                poke::log_level::debug,
+                poke::log::str{"message", "Recording family does not exist"},
+                poke::log::str{"path", base_path.string()});
+
+            created = create_recording(base_path, produced);
+        }
+        // A new base is the produced data, otherwise the base is loaded
+        std::string_view base = produced;
+        std::pmr::string loaded_base(memory_resource());
+        if (!created)
+        {
+            auto loaded = load_recording(base_path);
+            if (!loaded)
+            {
+                return tl::make_unexpected(loaded.error());
+            }
+            loaded_base = std::move(*loaded);
+            base = loaded_base;
+        }
+
+        if (!std::filesystem::exists(delta_path))
+        {
+            m_monitor.log(
+                poke::log_level::debug,
+                poke::log::str{"message", "Variant does not exist"},
+                poke::log::str{"path", delta_path.string()});
+
+            if (create_recording(delta_path, encode_delta(base, produced),
+                                 std::ios::binary))
+            {
+                return {};
+            }
+        }
+
+        auto loaded = load_recording(delta_path, std::ios::binary);
+        if (!loaded)
+        {
+            return tl::make_unexpected(loaded.error());
+        }
+        const std::pmr::string& delta = *loaded;
+
+        tl::expected<void, std::string> result;
+        if (m_comparator)
+        {
+            auto recording = apply_delta(base, delta);
+            result = recording ? (*m_comparator)(produced, *recording)
+                               : tl::make_unexpected(recording.error());
+        }
+        else
+        {
+            result = compare_delta(produced, base, delta);
+        }
+
+        if (result)
+        {
+            m_monitor.log(poke::log_level::debug,
+                          poke::log::str{"message", "No mismatch found"});
+            return {};
+        }
+
+        // Only build the recorded variant for the mismatch handler
+        auto recording = apply_delta(base, delta);
+        return report_mismatch(produced,
+                               recording ? *recording : std::string{},
+                               result.error(), delta_path);
+    }
+
+    /// Record an event log of the inputs to a component, see event_log. On a
+    /// mismatch the description holds the first differing event.
+    ///
+    /// The comparator and normalizer set on the recorder are not used.
+    auto record_events(const event_log& log) -> tl::expected<void, poke::error>
+    {
+        return record_binary(log.data(), event_log_comparator());
+    }
+
+    /// Feed the events of the recorded event log to the handler as fast as
+    /// possible, see replay(). Returns the throughput of the handler, or an
+    /// error if there is no valid recorded event log.
+    ///
+    /// Example:
+    ///     auto stats = recorder.replay_events(
+    ///         [&](const datarecorder::event_view& event)
+    ///         { decoder.consume(event.payload); });
+    ///     std::cout << stats->events_per_second() << std::endl;
+    auto replay_events(const std::function<void(const event_view&)>& handler)
+        -> tl::expected<replay_stats, poke::error>
+    {
+        std::filesystem::path recording_path = prepare_recording_path();
+        if (!std::filesystem::exists(recording_path))
+        {
+            return tl::make_unexpected(poke::make_error(
+                std::make_error_code(std::errc::no_such_file_or_directory),
+                poke::log::str{"message", "No recorded event log"},
+                poke::log::str{"path", recording_path.string()}));
+        }
+
+        auto log = load_recording(recording_path, std::ios::binary);
+        if (!log)
+        {
+            return tl::make_unexpected(log.error());
+        }
+        auto stats = replay(*log, handler);
+        if (!stats)
+        {
+            return tl::make_unexpected(poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"message", stats.error()},
+                poke::log::str{"path", recording_path.string()}));
+        }
+
+        m_monitor.log(
+            poke::log_level::debug,
+            poke::log::str{"message", "Replayed event log"},
+            poke::log::str{"events", std::to_string(stats->events)},
+            poke::log::str{"events_per_second",
+                           std::to_string(stats->events_per_second())});
+        return *stats;
+    }
+
+    /// Convenience function to record a vector of strings.
+    auto record(const std::vector<std::string>& data)
+        -> tl::expected<void, poke::error>
+    {
+        // We have to build a single string from the vector
+        std::size_t size = 0;
+        for (const auto& line : data)
+        {
+            size += line.size() + 1;
+        }
+
+        std::pmr::string data_string(memory_resource());
+        data_string.reserve(size);
+        for (const auto& line : data)
+        {
+            data_string += line;
+            data_string += '\n';
+        }
+        return record(data_string);
+    }
+
+    auto monitor() -> poke::monitor&
+    {
+        return m_monitor;
+    }
+
+private:
+    /// Make sure the mismatch handler and the recording filename are set
+    /// and return the recording path
+    auto prepare_recording_path() -> std::filesystem::path
     {
         // Check if we have a missmatch handler
         if (!m_on_mismatch)
@@ -159,84 +633,129 @@ public:
         // Check if the recording path is set
         VERIFY(m_recording_dir);
 
-        if (!m_recording_filename)
+        // A derived filename follows the current test name, so one recorder
+        // can be used for several scoped names
+        if (!m_recording_filename || m_derived_filename)
         {
             m_recording_filename = testname_as_filename();
+            m_derived_filename = true;
             m_monitor.log(
                 poke::log_level::debug,
                 poke::log::str{"message", "Recording filename not set"},
                 poke::log::str{"test_name", *m_recording_filename});
         }
 
-        std::filesystem::path recording_path =
-            m_recording_dir.value() / m_recording_filename.value();
+        return m_recording_dir.value() / m_recording_filename.value();
+    }
 
-        // Check if the file exists
-        if (std::filesystem::exists(recording_path))
+    /// Record binary data checked with the comparator
+    auto record_binary(std::string_view data, const comparator& compare)
+        -> tl::expected<void, poke::error>
+    {
+        std::filesystem::path recording_path = prepare_recording_path();
+
+        if (!std::filesystem::exists(recording_path))
         {
             m_monitor.log(
                 poke::log_level::debug,
-                poke::log::str{"message", "Recording file already exists"},
+                poke::log::str{"message", "Recording file does not exist"},
                 poke::log::str{"path", recording_path.string()});
 
-            // Read the data from the recording path
-            std::string recording_data = read_data(recording_path);
-
-            // Compare the data
-            return compare_data(data, recording_data);
+            if (create_recording(recording_path, data, std::ios::binary))
+            {
+                return {};
+            }
         }
-        else
+
+        auto recording_data = load_recording(recording_path, std::ios::binary);
+        if (!recording_data)
         {
-            m_monitor.log(
-                poke::log_level::debug,
-                poke::log::str{"message", "Recording file does not exist"},
-                poke::log::str{"path", recording_path.string()});
+            return tl::make_unexpected(recording_data.error());
+        }
 
-            // If it does not exist we create it
-            write_data(recording_path, data);
+        auto result = compare(data, *recording_data);
+        if (!result)
+        {
+            return report_mismatch(data, *recording_data, result.error());
         }
 
-        // If we get here we are good
+        m_monitor.log(poke::log_level::debug,
+                      poke::log::str{"message", "No mismatch found"});
         return {};
     }
 
-    /// Convenience function to record a vector of strings.
-    auto record(const std::vector<std::string>& data)
-        -> tl::expected<void, poke::error>
+    /// Append the use of the recording to the usage journal, if any
+    void journal_usage(const std::filesystem::path& recording_path,
+                       std::string_view recording_data)
     {
-        // We have to build a single string from the vector
-        std::string data_string;
-        for (const auto& data : data)
+        usage_journal* journal = active_journal();
+        if (journal == nullptr)
         {
-            data_string += data + "\n";
+            return;
         }
-        return record(data_string);
+
+        VERIFY(m_recording_dir.has_value());
+
+        journal_entry entry;
+        entry.test = current_test_name().value_or("");
+        entry.recording =
+            recording_path.lexically_relative(*m_recording_dir)
+                .generic_string();
+        entry.hash = fnv1a_64(recording_data);
+        journal->add(entry);
     }
 
-    auto monitor() -> poke::monitor&
+    /// The journal set with set_usage_journal() or the process-wide one
+    auto active_journal() const -> usage_journal*
     {
-        return m_monitor;
+        return m_usage_journal ? m_usage_journal : usage_journal::instance();
     }
 
-private:
     auto testname_as_filename() -> std::string
     {
-        // Get the current test name
-        auto* test_info =
-            ::testing::UnitTest::GetInstance()->current_test_info();
-
-        std::string test_case = test_info->test_case_name();
-        std::string test_name = test_info->name();
+        std::optional<std::string> name = current_test_name();
 
-        VERIFY(!test_case.empty());
-        VERIFY(!test_name.empty());
+        VERIFY(name.has_value() && !name->empty(),
+               "No recording filename set and no test name provided");
 
-        std::string filename = test_case + "_" + test_name + ".data";
+        std::string filename = *name + ".data";
         return filename;
     }
 
+    auto current_test_name() const -> std::optional<std::string>
+    {
+        // Use the name provider if set, then a scoped name and finally the
+        // running Google Test test
+        std::optional<std::string> name;
+        if (m_name_provider)
+        {
+            name = (*m_name_provider)();
+        }
+        if (!name)
+        {
+            name = scoped_name::current();
+        }
+#if !defined(DATARECORDER_DISABLE_GTEST)
+        if (!name)
+        {
+            name = gtest_name_provider()();
+        }
+#endif
+        return name;
+    }
+
     void determine_mismatch_handler()
     {
+        if (std::getenv("DATARECORDER_SESSION") != nullptr ||
+            std::getenv("DATARECORDER_SESSION_DIR") != nullptr)
+        {
+            m_monitor.log(poke::log_level::debug,
+                          poke::log::str{"message", "Using session"});
+
+            use_session();
+            return;
+        }
+
         auto visualizer = find_relative_path("visualizer/recording_diff.html");
 
         if (visualizer)
@@ -272,84 +791,187 @@ private:
 
         // Put the mismatch in /tmp/cppmismatch-N/file_name where N is
         // a concecutive number incremented if already exists
-        std::filesystem::path tmp_dir = std::filesystem::temp_directory_path();
-        std::filesystem::path mismatch_dir = tmp_dir / "cppmismatch-0";
+        return next_mismatch_dir();
+    }
 
-        std::size_t i = 0;
-        while (std::filesystem::exists(mismatch_dir))
+    void write_data(const std::filesystem::path& path, std::string_view data)
+    {
+        write_file(path, data);
+    }
+
+    /// Create the recording with a header and a checksum trailer if they are
+    /// enabled, unless it exists, see create_file_exclusive(). Returns false
+    /// if the recording exists.
+    auto create_recording(const std::filesystem::path& path,
+                          std::string_view data, std::ios::openmode mode = {})
+        -> bool
+    {
+        std::pmr::string buffer(memory_resource());
+        std::string_view content = data;
+        if (m_header || m_checksums)
         {
-            ++i;
-            mismatch_dir = tmp_dir / ("cppmismatch-" + std::to_string(i));
+            buffer.reserve(recording_header_size + data.size() +
+                           checksum_trailer_size);
+            if (m_header)
+            {
+                append_recording_header(buffer, make_recording_header(data));
+            }
+            buffer.append(data.data(), data.size());
+            if (m_checksums)
+            {
+                append_checksum_trailer(buffer);
+            }
+            content = buffer;
         }
 
-        // Return the path without creating the directory
-        return mismatch_dir;
+        if (!create_file_exclusive(path, content, mode))
+        {
+            return false;
+        }
+        journal_usage(path, content);
+        return true;
     }
 
-    void write_data(const std::filesystem::path& path, const std::string& data)
+    /// Read the recording and verify its checksum trailer and header if it
+    /// has them. Both are removed. A corrupt recording is an error and not a
+    /// mismatch.
+    auto load_recording(const std::filesystem::path& path,
+                        std::ios::openmode mode = {})
+        -> tl::expected<std::pmr::string, poke::error>
     {
-        // Create parent directories if they don't exist
-        std::filesystem::path parent_dir = path.parent_path();
-        if (!parent_dir.empty() && !std::filesystem::exists(parent_dir))
+        std::pmr::string data = (mode & std::ios::binary)
+                                    ? read_binary_file(path, memory_resource())
+                                    : read_file(path, memory_resource());
+        journal_usage(path, data);
+
+        auto content = verify_checksum_trailer(data);
+        if (content && content->size() == data.size() && m_checksums)
+        {
+            content = tl::make_unexpected(std::string(
+                "no checksum trailer, the recording is truncated or was "
+                "recorded without checksums"));
+        }
+        if (content)
         {
-            std::error_code ec;
-            bool created = std::filesystem::create_directories(parent_dir, ec);
-            VERIFY(created || std::filesystem::exists(parent_dir),
-                   "Could not create parent directories", ec, parent_dir);
+            content = verify_recording_header(*content);
+        }
+        if (!content)
+        {
+            m_monitor.log(poke::log_level::debug,
+                          poke::log::str{"message", "Recording is corrupt"},
+                          poke::log::str{"description", content.error()});
+
+            return tl::make_unexpected(poke::make_error(
+                std::make_error_code(std::errc::illegal_byte_sequence),
+                poke::log::str{"message", "Recording is corrupt"},
+                poke::log::str{"recording_path:", path.string()},
+                poke::log::str{"description:", content.error()}));
         }
 
-        std::ofstream file(path, std::ios::out | std::ios::trunc);
-        VERIFY(file.is_open(), "Could not open file for writing", errno, path);
+        std::size_t offset = content->data() - data.data();
+        data.resize(offset + content->size());
+        data.erase(0, offset);
+        return data;
+    }
 
-        file << data;
-        file.close();
+    /// Compare the size and format of the data, normalized if a normalizer
+    /// is set, with the header of the recording. Only the header is read.
+    /// Returns a description of the mismatch, or nothing if the recording
+    /// has no valid header or the header agrees with the data.
+    auto compare_header(const std::filesystem::path& path,
+                        std::string_view data) const
+        -> std::optional<std::string>
+    {
+        char prefix[recording_header_size];
+        std::size_t size = read_file_prefix(path, prefix, sizeof(prefix));
+        auto header = decode_recording_header({prefix, size});
+        if (!header)
+        {
+            return std::nullopt;
+        }
+
+        // The format is only known for data that is not normalized
+        std::uint64_t data_size = data.size();
+        if (m_normalizer)
+        {
+            data_size = 0;
+            m_normalizer->apply(data,
+                                [&data_size](std::string_view piece)
+                                {
+                                    data_size += piece.size();
+                                    return true;
+                                });
+        }
+        else if (detect_format(data) != header->format)
+        {
+            return std::string("the format of the data differs from the "
+                               "format in the recording header");
+        }
 
-        VERIFY(file.good(), "Could not write to file", errno);
+        if (data_size != header->payload_size)
+        {
+            return "the data has " + std::to_string(data_size) +
+                   " bytes, the recording header announces " +
+                   std::to_string(header->payload_size);
+        }
+        return std::nullopt;
     }
 
-    auto read_data(const std::filesystem::path& path) -> std::string
+    /// The memory resource the buffers are allocated from
+    auto memory_resource() const -> std::pmr::memory_resource*
     {
-        std::ifstream file(path, std::ios::in);
-        VERIFY(file.is_open(), "Could not open file for reading", errno);
-
-        // Read all data from the file
-        std::string data{std::istreambuf_iterator<char>(file),
-                         std::istreambuf_iterator<char>()};
+        if (m_memory_resource != nullptr)
+        {
+            return m_memory_resource;
+        }
+        if (std::pmr::memory_resource* arena = scoped_arena::current())
+        {
+            return arena;
+        }
+        return std::pmr::get_default_resource();
+    }
 
-        file.close();
+    /// Return the data normalized with the normalizer, or the data itself
+    /// if there is no normalizer. The normalized data is kept in the buffer.
+    auto normalize(std::string_view data, std::pmr::string& buffer) const
+        -> std::string_view
+    {
+        if (!m_normalizer)
+        {
+            return data;
+        }
 
-        return data;
+        buffer.clear();
+        buffer.reserve(data.size());
+        m_normalizer->apply(data,
+                            [&buffer](std::string_view piece)
+                            {
+                                buffer.append(piece.data(), piece.size());
+                                return true;
+                            });
+        return buffer;
     }
 
-    auto compare_data(const std::string& data,
-                      const std::string& recording_data)
+    auto compare_data(std::string_view data, std::string_view recording_data)
         -> tl::expected<void, poke::error>
     {
         VERIFY(m_recording_filename.has_value(),
                "Recording filename must not be empty");
 
-        if (data != recording_data)
+        // Use the comparator if set, otherwise the data must be equal
+        tl::expected<void, std::string> result;
+        if (m_comparator)
         {
-            // If it exists we check for a mismatch
-            std::filesystem::path mismatch_dir = determine_mismatch_path();
-
-            m_monitor.log(poke::log_level::debug,
-                          poke::log::str{"message", "Mismatch found"});
-
-            // We have a mismatch
-            mismatch_info mismatch;
-            mismatch.recording_data = recording_data;
-            mismatch.mismatch_data = data;
-            mismatch.mismatch_dir = mismatch_dir;
-
-            VERIFY(m_recording_filename.has_value());
-            VERIFY(m_recording_dir.has_value());
-
-            mismatch.recording_path =
-                m_recording_dir.value() / m_recording_filename.value();
+            result = (*m_comparator)(data, recording_data);
+        }
+        else if (data != recording_data)
+        {
+            result = tl::make_unexpected(std::string{});
+        }
 
-            VERIFY(m_on_mismatch, "Mismatch handler not set");
-            return tl::make_unexpected(m_on_mismatch.value()(mismatch));
+        if (!result)
+        {
+            return report_mismatch(data, recording_data, result.error());
         }
         else
         {
@@ -360,6 +982,36 @@ private:
         }
     }
 
+    /// Pass the mismatch to the mismatch handler
+    auto report_mismatch(std::string_view data, std::string_view recording_data,
+                         std::string description,
+                         std::filesystem::path recording_path = {})
+        -> tl::expected<void, poke::error>
+    {
+        std::filesystem::path mismatch_dir = determine_mismatch_path();
+
+        m_monitor.log(poke::log_level::debug,
+                      poke::log::str{"message", "Mismatch found"});
+
+        // We have a mismatch
+        mismatch_info mismatch;
+        mismatch.recording_data = std::string(recording_data);
+        mismatch.mismatch_data = std::string(data);
+        mismatch.mismatch_dir = mismatch_dir;
+        mismatch.description = std::move(description);
+
+        VERIFY(m_recording_filename.has_value());
+        VERIFY(m_recording_dir.has_value());
+
+        mismatch.recording_path =
+            recording_path.empty()
+                ? m_recording_dir.value() / m_recording_filename.value()
+                : recording_path;
+
+        VERIFY(m_on_mismatch, "Mismatch handler not set");
+        return tl::make_unexpected(m_on_mismatch.value()(mismatch));
+    }
+
     auto find_relative_path(const std::filesystem::path& path) const
         -> tl::expected<std::filesystem::path, poke::error>
     {
@@ -415,54 +1067,192 @@ private:
             poke::log::str{"recording_diff_html", recording_diff_html.string()},
             mismatch);
 
-        auto escape_dollar_bracs = [](const std::string& input)
+        // Identical mismatches point at the artifacts already written
+        std::uint64_t fingerprint = mismatch_fingerprint(mismatch);
+        if (auto artifact = mismatch_registry::instance().find(fingerprint))
         {
-            // When we insert the string in the HTML file we need to escape
-            // the dollar brackets. Since this is interpreted as a template
-            // string litteral in javascript. So we need to escape it with a
-            // backslash.
-            static const std::regex pattern(R"(\$\{[^}]+\})");
-            return std::regex_replace(input, pattern, R"(\$&)");
-        };
-
-        std::string escaped_recording_data =
-            escape_dollar_bracs(mismatch.recording_data);
-        std::string escaped_mismatch_data =
-            escape_dollar_bracs(mismatch.mismatch_data);
-
-        std::string file_content = read_data(recording_diff_html);
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"message", "Mismatch found (duplicate)"},
+                poke::log::str{"recording_path:",
+                               mismatch.recording_path.string()},
+                poke::log::str{"description:", mismatch.description},
+                poke::log::str{"mismatch_dir:", artifact->string()},
+                poke::log::str{"fingerprint", to_hex(fingerprint)});
+        }
 
-        std::regex oldTextPattern(R"((const\s+oldText\s*=\s*`)([^`]*)(`;))");
-        std::regex newTextPattern(R"((const\s+newText\s*=\s*`)([^`]*)(`;))");
+        // Large data is not inlined in the visualizer since browsers cannot
+        // handle template literals of that size
+        bool inline_data = mismatch.recording_data.size() +
+                               mismatch.mismatch_data.size() <=
+                           m_inline_diff_limit;
 
-        file_content = std::regex_replace(file_content, oldTextPattern,
-                                          "$1" + escaped_recording_data + "$3");
-        file_content = std::regex_replace(file_content, newTextPattern,
-                                          "$1" + escaped_mismatch_data + "$3");
+        // Check the budget before doing any work. Besides the produced data
+        // either the visualizer with both inputs or the hunks, which are
+        // bounded by the size of both inputs, are written.
+        std::uint64_t artifact_bytes = mismatch.recording_data.size() +
+                                       2 * mismatch.mismatch_data.size();
 
-        // Output file
-        std::filesystem::path output_file =
-            mismatch.mismatch_dir / recording_diff_html.filename();
+        if (!artifact_budget::instance().reserve(artifact_bytes))
+        {
+            return summary_mismatch_handler(mismatch);
+        }
 
-        // Write the modified content back to the file
-        write_data(output_file, file_content);
+        // Another process may have taken the mismatch directory since it
+        // was chosen, then the next free one is used
+        mismatch.mismatch_dir = create_mismatch_dir(mismatch.mismatch_dir);
 
-        // Also write the mismatch data to the mismatch dir
+        // Write the produced data to the mismatch dir
         std::filesystem::path mismatch_path =
             mismatch.mismatch_dir / mismatch.recording_path.filename();
 
         write_data(mismatch_path, mismatch.mismatch_data);
 
+        mismatch_registry::instance().insert(fingerprint,
+                                             mismatch.mismatch_dir);
+
+        if (!inline_data)
+        {
+            // Write the precomputed hunks to a side file together with a
+            // viewer that only renders the visible part of the diff
+            std::filesystem::path hunks_html =
+                write_hunks(mismatch, mismatch_path);
+
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"message", "Mismatch found"},
+                poke::log::str{"recording_path:",
+                               mismatch.recording_path.string()},
+                poke::log::str{"description:", mismatch.description},
+                poke::log::str{"mismatch_path:", mismatch_path.string()},
+                poke::log::str{"html_hunks", hunks_html.string()});
+        }
+
+        // The template is read and split once per process
+        auto visualizer = visualizer_template::load(recording_diff_html);
+
+        // Output file
+        std::filesystem::path output_file =
+            mismatch.mismatch_dir / recording_diff_html.filename();
+
+        // Stream the template with the data in its slots to the file
+        std::ofstream file = open_output_file(output_file);
+        visualizer->write(file,
+                          [&](std::ostream& out, visualizer_template::slot slot)
+                          {
+                              if (slot ==
+                                  visualizer_template::slot::recording_data)
+                              {
+                                  escape_dollar_bracs(out,
+                                                      mismatch.recording_data);
+                              }
+                              else
+                              {
+                                  escape_dollar_bracs(out,
+                                                      mismatch.mismatch_data);
+                              }
+                          });
+        file.close();
+        VERIFY(file.good(), "Could not write to file", errno, output_file);
+
         return poke::make_error(
             std::make_error_code(std::errc::invalid_argument),
             poke::log::str{"message", "Mismatch found"},
             poke::log::str{"recording_data:", mismatch.recording_data},
             poke::log::str{"mismatch_data:", mismatch.mismatch_data},
             poke::log::str{"recording_path:", mismatch.recording_path.string()},
+            poke::log::str{"description:", mismatch.description},
             poke::log::str{"mismatch_path:", mismatch_path.string()},
             poke::log::str{"html_diff", output_file.string()});
     }
 
+    /// Write the hunks of the mismatch to recording_diff.hunks.js in the
+    /// mismatch dir together with the page viewing them, whose path is
+    /// returned
+    auto write_hunks(const mismatch_info& mismatch,
+                     const std::filesystem::path& mismatch_path)
+        -> std::filesystem::path
+    {
+        std::filesystem::path hunks_file =
+            mismatch.mismatch_dir / "recording_diff.hunks.js";
+        std::filesystem::path hunks_html =
+            mismatch.mismatch_dir / "recording_hunks.html";
+
+        std::string hunks = "window.datarecorder_hunks = {\"recording_path\": ";
+        append_json_string(hunks, mismatch.recording_path.string());
+        hunks += ", \"mismatch_path\": ";
+        append_json_string(hunks, mismatch_path.string());
+        hunks += ", \"recording_size\": " +
+                 std::to_string(mismatch.recording_data.size()) +
+                 ", \"mismatch_size\": " +
+                 std::to_string(mismatch.mismatch_data.size()) +
+                 ", \"hunks\": ";
+        append_hunks_json(
+            hunks, diff_lines(mismatch.recording_data, mismatch.mismatch_data));
+        hunks += "};\n";
+
+        write_data(hunks_file, hunks);
+        write_data(hunks_html, hunk_viewer_html());
+        return hunks_html;
+    }
+
+    auto session_mismatch_handler(mismatch_info mismatch) -> poke::error
+    {
+        m_monitor.log(
+            poke::log_level::debug,
+            poke::log::str{"message", "Using session mismatch handler"},
+            mismatch);
+
+        // Identical mismatches are only counted by the session, so the
+        // budget is reserved for new mismatches only
+        bool duplicate =
+            session::instance().contains(mismatch_fingerprint(mismatch));
+        if (!duplicate &&
+            !artifact_budget::instance().reserve(mismatch.mismatch_data.size()))
+        {
+            return summary_mismatch_handler(mismatch);
+        }
+
+        std::filesystem::path mismatch_path = session::instance().add(mismatch);
+
+        return poke::make_error(
+            std::make_error_code(std::errc::invalid_argument),
+            poke::log::str{"message", "Mismatch found"},
+            poke::log::str{"recording_path:", mismatch.recording_path.string()},
+            poke::log::str{"description:", mismatch.description},
+            poke::log::str{"mismatch_path:", mismatch_path.string()},
+            poke::log::str{"session_index",
+                           session::instance().index_path().string()});
+    }
+
+    auto summary_mismatch_handler(const mismatch_info& mismatch) -> poke::error
+    {
+        m_monitor.log(
+            poke::log_level::debug,
+            poke::log::str{"message", "Artifact budget exhausted"},
+            poke::log::str{"report", artifact_budget::instance().report()});
+
+        // Only report where the data starts to differ
+        const std::string& recording = mismatch.recording_data;
+        const std::string& data = mismatch.mismatch_data;
+        auto first = std::mismatch(recording.begin(), recording.end(),
+                                   data.begin(), data.end());
+        std::size_t offset = first.first - recording.begin();
+        std::size_t line =
+            std::count(recording.begin(), first.first, '\n') + 1;
+
+        return poke::make_error(
+            std::make_error_code(std::errc::invalid_argument),
+            poke::log::str{"message",
+                           "Mismatch found (artifact budget exhausted)"},
+            poke::log::str{"recording_path:", mismatch.recording_path.string()},
+            poke::log::str{"description:", mismatch.description},
+            poke::log::str{"recording_size", std::to_string(recording.size())},
+            poke::log::str{"mismatch_size", std::to_string(data.size())},
+            poke::log::str{"first_difference_offset", std::to_string(offset)},
+            poke::log::str{"first_difference_line", std::to_string(line)});
+    }
+
     auto default_mismatch_handler(mismatch_info mismatch) -> poke::error
 
     {
@@ -470,7 +1260,8 @@ private:
         return poke::make_error(
             std::make_error_code(std::errc::invalid_argument),
             poke::log::str{"recording_data:", mismatch.recording_data},
-            poke::log::str{"mismatch_data:", mismatch.mismatch_data});
+            poke::log::str{"mismatch_data:", mismatch.mismatch_data},
+            poke::log::str{"description:", mismatch.description});
     }
 
 private:
@@ -478,8 +1269,36 @@ private:
     poke::monitor m_monitor;
 
     std::optional<std::string> m_recording_filename;
+
+    /// True if the recording filename is derived from the test name
+    bool m_derived_filename = false;
+
     std::optional<std::filesystem::path> m_recording_dir;
     std::optional<std::function<poke::error(mismatch_info)>> m_on_mismatch;
+
+    /// Provides the name of the recording if the filename is not set
+    std::optional<name_provider> m_name_provider;
+
+    /// Comparator used instead of checking the data for equality
+    std::optional<comparator> m_comparator;
+
+    /// Normalizer applied to the data before it is compared or stored
+    std::optional<normalizer> m_normalizer;
+
+    /// Mismatches larger than this are not inlined in the diff visualizer
+    std::size_t m_inline_diff_limit = 1024 * 1024;
+
+    /// The journal set with set_usage_journal()
+    usage_journal* m_usage_journal = nullptr;
+
+    /// The memory resource set with set_memory_resource()
+    std::pmr::memory_resource* m_memory_resource = nullptr;
+
+    /// True if recordings are written with a checksum trailer
+    bool m_checksums = false;
+
+    /// True if recordings are written with a header
+    bool m_header = false;
 };
 
 }
\ No newline at end of file
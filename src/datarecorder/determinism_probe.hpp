@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tl/expected.hpp>
+#include <verify/verify.hpp>
+
+#include "hash.hpp"
+
+namespace datarecorder
+{
+
+/// Run the producer the given number of times on parallel threads and
+/// check that every run produces the same output. Returns the output if
+/// all runs agree, otherwise a description of the byte ranges that vary
+/// between the runs. The outputs are compared by their hashes first. Runs
+/// with different hashes differ, runs with equal hashes are confirmed by
+/// comparing the bytes.
+///
+/// The producer must be safe to call from several threads at once. An
+/// exception thrown by the producer is rethrown on the calling thread.
+///
+/// Example:
+///     auto output = datarecorder::probe_determinism(
+///         [] { return simulate(42); }, 4);
+inline auto probe_determinism(const std::function<std::string()>& producer,
+                              std::size_t runs, std::size_t max_ranges = 10)
+    -> tl::expected<std::string, std::string>
+{
+    VERIFY(runs > 0, "At least one run is needed");
+
+    std::vector<std::string> outputs(runs);
+    std::vector<std::uint64_t> hashes(runs);
+    std::vector<std::exception_ptr> errors(runs);
+
+    auto run = [&](std::size_t i)
+    {
+        try
+        {
+            outputs[i] = producer();
+            hashes[i] = fnv1a_64(outputs[i]);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < runs; ++i)
+    {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t differing_runs = 0;
+    for (std::size_t i = 1; i < runs; ++i)
+    {
+        if (hashes[i] != hashes[0] || outputs[i] != outputs[0])
+        {
+            ++differing_runs;
+        }
+    }
+    if (differing_runs == 0)
+    {
+        return std::move(outputs[0]);
+    }
+
+    // Find the byte ranges where any run differs from the first run
+    std::size_t size = 0;
+    for (const auto& output : outputs)
+    {
+        size = std::max(size, output.size());
+    }
+    auto varies = [&outputs](std::size_t i)
+    {
+        for (std::size_t run = 1; run < outputs.size(); ++run)
+        {
+            bool in_first = i < outputs[0].size();
+            bool in_run = i < outputs[run].size();
+            if (in_first != in_run ||
+                (in_run && outputs[run][i] != outputs[0][i]))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::string ranges;
+    std::size_t range_count = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (!varies(i))
+        {
+            continue;
+        }
+        std::size_t begin = i;
+        while (i < size && varies(i))
+        {
+            ++i;
+        }
+        if (range_count++ < max_ranges)
+        {
+            const std::string& first = outputs[0];
+            std::size_t line =
+                std::count(first.begin(),
+                           first.begin() + std::min(begin, first.size()),
+                           '\n') +
+                1;
+            ranges += "\n  bytes [" + std::to_string(begin) + ", " +
+                      std::to_string(i) + ") at line " + std::to_string(line);
+        }
+    }
+    if (range_count > max_ranges)
+    {
+        ranges += "\n  ... " + std::to_string(range_count - max_ranges) +
+                  " more";
+    }
+
+    std::string sizes;
+    for (const auto& output : outputs)
+    {
+        sizes += (sizes.empty() ? "" : ", ") + std::to_string(output.size());
+    }
+
+    return tl::make_unexpected(
+        std::to_string(differing_runs) + " of " + std::to_string(runs - 1) +
+        " runs differ from the first run (output sizes " + sizes +
+        "), varying byte ranges:" + ranges);
+}
+
+}
\ No newline at end of file
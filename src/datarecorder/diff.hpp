@@ -0,0 +1,505 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hash.hpp"
+
+namespace datarecorder
+{
+
+/// A single line in a diff hunk
+struct diff_line
+{
+    /// The operation: ' ' for context, '-' for a line only in the recording
+    /// and '+' for a line only in the produced data
+    char op;
+
+    /// The line without the line terminator
+    std::string text;
+};
+
+/// A group of changed lines surrounded by context lines
+struct diff_hunk
+{
+    /// Index of the first line of the hunk in the recording (zero-based)
+    std::size_t recording_line = 0;
+
+    /// Number of recording lines covered by the hunk
+    std::size_t recording_count = 0;
+
+    /// Byte offset of the first line of the hunk in the recording
+    std::size_t recording_offset = 0;
+
+    /// Index of the first line of the hunk in the produced data (zero-based)
+    std::size_t mismatch_line = 0;
+
+    /// Number of produced lines covered by the hunk
+    std::size_t mismatch_count = 0;
+
+    /// Byte offset of the first line of the hunk in the produced data
+    std::size_t mismatch_offset = 0;
+
+    /// The lines of the hunk
+    std::vector<diff_line> lines;
+
+    /// True if the hunk is a block of recording_count lines moved unchanged
+    /// from recording_line to mismatch_line. A moved hunk has no lines.
+    bool moved = false;
+};
+
+/// Return the header of the hunk: "@@ -r,rc +m,mc @@", or "@@ moved lines
+/// X-Y to Z @@" for a moved block, with one-based line numbers
+inline auto hunk_header(const diff_hunk& hunk) -> std::string
+{
+    if (hunk.moved)
+    {
+        std::size_t last = hunk.recording_line + hunk.recording_count;
+        return "@@ moved lines " + std::to_string(hunk.recording_line + 1) +
+               "-" + std::to_string(last) + " to " +
+               std::to_string(hunk.mismatch_line + 1) + " @@";
+    }
+    return "@@ -" + std::to_string(hunk.recording_line + 1) + "," +
+           std::to_string(hunk.recording_count) + " +" +
+           std::to_string(hunk.mismatch_line + 1) + "," +
+           std::to_string(hunk.mismatch_count) + " @@";
+}
+
+/// Split data into lines. Each line keeps its line terminator such that
+/// "a" and "a\n" are not considered equal.
+inline auto split_lines(std::string_view data) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> lines;
+    std::size_t start = 0;
+    while (start < data.size())
+    {
+        std::size_t end = data.find('\n', start);
+        if (end == std::string_view::npos)
+        {
+            lines.push_back(data.substr(start));
+            break;
+        }
+        lines.push_back(data.substr(start, end - start + 1));
+        start = end + 1;
+    }
+    return lines;
+}
+
+/// Compute the line based edit script turning the lines a into the lines b.
+/// The script has one operation per line: ' ' for a line in both, '-' for a
+/// line only in a and '+' for a line only in b.
+///
+/// The edit script is found with the Myers O(ND) algorithm on interned
+/// lines after stripping the common prefix and suffix. If the number of
+/// edits exceeds max_edits the remaining region is reported as a single
+/// replacement, which keeps the cost bounded for completely different inputs.
+inline auto diff_script(const std::vector<std::string_view>& a,
+                        const std::vector<std::string_view>& b,
+                        std::size_t max_edits = 2048) -> std::string
+{
+    // Strip the common prefix and suffix, these lines are unchanged
+    std::size_t prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix])
+    {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+           a[a.size() - 1 - suffix] == b[b.size() - 1 - suffix])
+    {
+        ++suffix;
+    }
+
+    // Intern the lines of the middle section so comparisons are integers
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+    auto intern = [&ids](std::string_view line)
+    {
+        return ids.emplace(line, static_cast<std::uint32_t>(ids.size()))
+            .first->second;
+    };
+
+    std::vector<std::uint32_t> x;
+    std::vector<std::uint32_t> y;
+    for (std::size_t i = prefix; i < a.size() - suffix; ++i)
+    {
+        x.push_back(intern(a[i]));
+    }
+    for (std::size_t i = prefix; i < b.size() - suffix; ++i)
+    {
+        y.push_back(intern(b[i]));
+    }
+
+    // The edit script over the middle section: ' ', '-' or '+' per line
+    std::string script;
+
+    const std::ptrdiff_t n = x.size();
+    const std::ptrdiff_t m = y.size();
+    const std::ptrdiff_t max = std::min<std::ptrdiff_t>(n + m, max_edits);
+    const std::ptrdiff_t offset = max + 1;
+
+    std::vector<std::ptrdiff_t> v(2 * offset + 1, 0);
+    std::vector<std::vector<std::ptrdiff_t>> trace;
+    bool found = false;
+
+    for (std::ptrdiff_t d = 0; d <= max && !found; ++d)
+    {
+        for (std::ptrdiff_t k = -d; k <= d; k += 2)
+        {
+            std::ptrdiff_t i;
+            if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+            {
+                i = v[offset + k + 1];
+            }
+            else
+            {
+                i = v[offset + k - 1] + 1;
+            }
+            std::ptrdiff_t j = i - k;
+            while (i < n && j < m && x[i] == y[j])
+            {
+                ++i;
+                ++j;
+            }
+            v[offset + k] = i;
+            if (i >= n && j >= m)
+            {
+                found = true;
+                break;
+            }
+        }
+        trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+    }
+
+    if (found)
+    {
+        // Backtrack through the trace to recover the edit script
+        std::ptrdiff_t i = n;
+        std::ptrdiff_t j = m;
+        for (std::ptrdiff_t d = trace.size() - 1; d > 0; --d)
+        {
+            const auto& previous = trace[d - 1];
+            auto at = [&previous, d](std::ptrdiff_t k)
+            { return previous[k + d - 1]; };
+
+            std::ptrdiff_t k = i - j;
+            std::ptrdiff_t prev_k;
+            if (k == -d || (k != d && at(k - 1) < at(k + 1)))
+            {
+                prev_k = k + 1;
+            }
+            else
+            {
+                prev_k = k - 1;
+            }
+            std::ptrdiff_t prev_i = at(prev_k);
+            std::ptrdiff_t prev_j = prev_i - prev_k;
+
+            while (i > prev_i && j > prev_j)
+            {
+                script += ' ';
+                --i;
+                --j;
+            }
+            script += (i == prev_i) ? '+' : '-';
+            i = prev_i;
+            j = prev_j;
+        }
+        script.append(i, ' ');
+        std::reverse(script.begin(), script.end());
+    }
+    else
+    {
+        // Too many edits, report the middle section as one replacement
+        script.assign(n, '-');
+        script.append(m, '+');
+    }
+
+    // Build the full script including the stripped prefix and suffix
+    return std::string(prefix, ' ') + script + std::string(suffix, ' ');
+}
+
+/// A block of lines moved unchanged from one position to another
+struct diff_move
+{
+    /// Index of the first line of the block in a (zero-based)
+    std::size_t a_line = 0;
+
+    /// Index of the first line of the block in b (zero-based)
+    std::size_t b_line = 0;
+
+    /// Number of lines in the block
+    std::size_t count = 0;
+};
+
+/// Find the blocks of at least min_lines lines which the edit script
+/// deletes from a and inserts unchanged elsewhere in b. The lines of a block
+/// are marked '<' instead of '-' and '>' instead of '+' in the script.
+///
+/// Every window of min_lines deleted lines is looked up by its Rabin-Karp
+/// rolling hash over the line hashes among the windows of inserted lines,
+/// and a match is extended for as long as the lines agree. This takes time
+/// linear in the number of lines when few windows collide.
+inline auto find_moves(const std::vector<std::string_view>& a,
+                       const std::vector<std::string_view>& b,
+                       std::string& script, std::size_t min_lines = 3)
+    -> std::vector<diff_move>
+{
+    std::vector<diff_move> moves;
+    if (min_lines == 0)
+    {
+        return moves;
+    }
+
+    // The operation of every line of a and b
+    std::string a_ops;
+    std::string b_ops;
+    for (char op : script)
+    {
+        if (op != '+')
+        {
+            a_ops += op;
+        }
+        if (op != '-')
+        {
+            b_ops += op;
+        }
+    }
+
+    // The rolling hash of the window of min_lines lines starting at each
+    // line, if all lines of the window have the operation
+    constexpr std::uint64_t base = 0x100000001b3ULL;
+    std::uint64_t power = 1;
+    for (std::size_t i = 1; i < min_lines; ++i)
+    {
+        power *= base;
+    }
+    auto windows = [&](const std::vector<std::string_view>& lines,
+                       const std::string& ops, char op)
+    {
+        std::vector<std::pair<std::size_t, std::uint64_t>> result;
+        std::uint64_t hash = 0;
+        std::size_t run = 0;
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            if (ops[i] != op)
+            {
+                run = 0;
+                continue;
+            }
+            if (run == min_lines)
+            {
+                hash -= fnv1a_64(lines[i - min_lines]) * power;
+                --run;
+            }
+            else if (run == 0)
+            {
+                hash = 0;
+            }
+            hash = hash * base + fnv1a_64(lines[i]);
+            if (++run == min_lines)
+            {
+                result.emplace_back(i + 1 - min_lines, hash);
+            }
+        }
+        return result;
+    };
+
+    std::unordered_multimap<std::uint64_t, std::size_t> inserted;
+    for (const auto& [line, hash] : windows(b, b_ops, '+'))
+    {
+        inserted.emplace(hash, line);
+    }
+    if (inserted.empty())
+    {
+        return moves;
+    }
+
+    for (const auto& [line, hash] : windows(a, a_ops, '-'))
+    {
+        // The window may be part of a move found earlier
+        if (a_ops[line] != '-')
+        {
+            continue;
+        }
+
+        auto range = inserted.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            std::size_t count = 0;
+            while (line + count < a.size() && it->second + count < b.size() &&
+                   a_ops[line + count] == '-' &&
+                   b_ops[it->second + count] == '+' &&
+                   a[line + count] == b[it->second + count])
+            {
+                ++count;
+            }
+            if (count < min_lines)
+            {
+                continue;
+            }
+
+            std::fill_n(a_ops.begin() + line, count, '<');
+            std::fill_n(b_ops.begin() + it->second, count, '>');
+            moves.push_back({line, it->second, count});
+            break;
+        }
+    }
+
+    // Mark the moved lines in the script
+    std::size_t ai = 0;
+    std::size_t bi = 0;
+    for (char& op : script)
+    {
+        if (op == '-')
+        {
+            op = a_ops[ai];
+        }
+        else if (op == '+')
+        {
+            op = b_ops[bi];
+        }
+        ai += op != '+' && op != '>';
+        bi += op != '-' && op != '<';
+    }
+    return moves;
+}
+
+/// Compute the line based difference between the recording and the produced
+/// data as a list of hunks with the given number of context lines, see
+/// diff_script(). Blocks of at least min_move_lines lines that were moved
+/// unchanged are reported as moved hunks instead of a deletion and an
+/// insertion, see find_moves(). Set min_move_lines to zero to disable this.
+inline auto diff_lines(std::string_view recording, std::string_view mismatch,
+                       std::size_t context = 3, std::size_t max_edits = 2048,
+                       std::size_t min_move_lines = 3)
+    -> std::vector<diff_hunk>
+{
+    auto a = split_lines(recording);
+    auto b = split_lines(mismatch);
+    std::string script = diff_script(a, b, max_edits);
+    auto moves = find_moves(a, b, script, min_move_lines);
+
+    auto text = [](std::string_view line)
+    {
+        if (!line.empty() && line.back() == '\n')
+        {
+            line.remove_suffix(1);
+        }
+        return std::string(line);
+    };
+
+    // Group the changes into hunks with the requested context. Changes
+    // separated by at most 2 * context unchanged or moved lines share a
+    // hunk. Moved lines are covered by a hunk but not shown in it.
+    std::vector<diff_hunk> hunks;
+    std::size_t pos = 0;
+    std::size_t ai = 0;
+    std::size_t bi = 0;
+    while (pos < script.size())
+    {
+        std::size_t change = script.find_first_of("-+", pos);
+        if (change == std::string::npos)
+        {
+            break;
+        }
+
+        std::size_t end = change;
+        while (true)
+        {
+            end = script.find_first_not_of("-+", end);
+            if (end == std::string::npos)
+            {
+                end = script.size();
+                break;
+            }
+            std::size_t next = script.find_first_of("-+", end);
+            if (next == std::string::npos || next - end > 2 * context)
+            {
+                break;
+            }
+            end = next;
+        }
+
+        // Skip the lines before the leading context
+        std::size_t begin = change - std::min(context, change - pos);
+        for (; pos < begin; ++pos)
+        {
+            ai += script[pos] != '>';
+            bi += script[pos] != '<';
+        }
+        std::size_t stop = std::min(script.size(), end + context);
+
+        diff_hunk hunk;
+        hunk.recording_line = ai;
+        hunk.mismatch_line = bi;
+        hunk.recording_offset =
+            ai < a.size() ? a[ai].data() - recording.data() : recording.size();
+        hunk.mismatch_offset =
+            bi < b.size() ? b[bi].data() - mismatch.data() : mismatch.size();
+        for (std::size_t s = begin; s < stop; ++s)
+        {
+            switch (script[s])
+            {
+            case ' ':
+                hunk.lines.push_back({' ', text(a[ai])});
+                ++ai;
+                ++bi;
+                ++hunk.recording_count;
+                ++hunk.mismatch_count;
+                break;
+            case '-':
+                hunk.lines.push_back({'-', text(a[ai])});
+                ++ai;
+                ++hunk.recording_count;
+                break;
+            case '+':
+                hunk.lines.push_back({'+', text(b[bi])});
+                ++bi;
+                ++hunk.mismatch_count;
+                break;
+            case '<':
+                ++ai;
+                ++hunk.recording_count;
+                break;
+            default:
+                ++bi;
+                ++hunk.mismatch_count;
+                break;
+            }
+        }
+        hunks.push_back(std::move(hunk));
+        pos = stop;
+    }
+
+    // Report every moved block as a single hunk without lines
+    for (const auto& move : moves)
+    {
+        diff_hunk hunk;
+        hunk.moved = true;
+        hunk.recording_line = move.a_line;
+        hunk.recording_count = move.count;
+        hunk.recording_offset = a[move.a_line].data() - recording.data();
+        hunk.mismatch_line = move.b_line;
+        hunk.mismatch_count = move.count;
+        hunk.mismatch_offset = b[move.b_line].data() - mismatch.data();
+        hunks.push_back(std::move(hunk));
+    }
+    std::stable_sort(hunks.begin(), hunks.end(),
+                     [](const diff_hunk& x, const diff_hunk& y)
+                     { return x.recording_line < y.recording_line; });
+
+    return hunks;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "comparator.hpp"
+#include "json_string.hpp"
+
+namespace datarecorder
+{
+
+/// An event of an event log. The payload points into the log.
+struct event_view
+{
+    /// The channel of the event e.g. packets, timers or API calls
+    std::uint32_t channel = 0;
+
+    /// The time of the event in a unit chosen by the user
+    std::uint64_t time = 0;
+
+    /// The payload of the event
+    std::string_view payload;
+};
+
+/// A compact binary log of the inputs to a component, such as packets,
+/// timer events and API calls, which can be recorded with
+/// datarecorder::record_events() and fed back with replay().
+///
+/// Every event is stored as variable length integers followed by the
+/// payload:
+///
+///     "DRE1"
+///     per event: varint channel, varint zigzag time delta,
+///                varint payload size, the payload
+///
+/// Example:
+///     datarecorder::event_log log;
+///     log.add(packet_channel, now, packet);
+///     log.add(timer_channel, now + 10, "");
+///     recorder.record_events(log);
+class event_log
+{
+public:
+    /// Constructor
+    event_log()
+    {
+        m_data.append("DRE1", 4);
+    }
+
+    /// Add an event
+    void add(std::uint32_t channel, std::uint64_t time,
+             std::string_view payload)
+    {
+        // Times are stored as differences, which are usually small
+        std::int64_t delta = static_cast<std::int64_t>(time - m_time);
+        std::uint64_t zigzag = (static_cast<std::uint64_t>(delta) << 1) ^
+                               static_cast<std::uint64_t>(delta >> 63);
+
+        append_varint(m_data, channel);
+        append_varint(m_data, zigzag);
+        append_varint(m_data, payload.size());
+        m_data.append(payload.data(), payload.size());
+
+        m_time = time;
+        ++m_events;
+    }
+
+    /// The number of events
+    auto events() const -> std::size_t
+    {
+        return m_events;
+    }
+
+    /// The encoded log
+    auto data() const -> const std::string&
+    {
+        return m_data;
+    }
+
+private:
+    std::string m_data;
+    std::uint64_t m_time = 0;
+    std::size_t m_events = 0;
+};
+
+/// Call the function with every event of the encoded log. The function
+/// returns false to stop. Returns the number of events visited, or an error
+/// if the log is invalid.
+template <class Function>
+auto for_each_event(std::string_view log, Function&& function)
+    -> tl::expected<std::size_t, std::string>
+{
+    auto invalid = []
+    { return tl::make_unexpected(std::string{"not a valid event log"}); };
+
+    binary_reader reader(log);
+    std::string_view magic;
+    if (!reader.read_bytes(4, magic) || magic != "DRE1")
+    {
+        return invalid();
+    }
+
+    std::size_t events = 0;
+    std::uint64_t time = 0;
+    while (reader.remaining() > 0)
+    {
+        std::uint64_t channel = 0;
+        std::uint64_t zigzag = 0;
+        std::uint64_t size = 0;
+        event_view event;
+        if (!reader.read_varint(channel) ||
+            channel > std::numeric_limits<std::uint32_t>::max() ||
+            !reader.read_varint(zigzag) || !reader.read_varint(size) ||
+            !reader.read_bytes(size, event.payload))
+        {
+            return invalid();
+        }
+
+        std::int64_t delta = static_cast<std::int64_t>(zigzag >> 1) ^
+                             -static_cast<std::int64_t>(zigzag & 1);
+        time += static_cast<std::uint64_t>(delta);
+
+        event.channel = static_cast<std::uint32_t>(channel);
+        event.time = time;
+        ++events;
+        if (!function(event))
+        {
+            break;
+        }
+    }
+    return events;
+}
+
+/// The throughput of a replay
+struct replay_stats
+{
+    /// The number of events replayed
+    std::size_t events = 0;
+
+    /// The number of payload bytes replayed
+    std::uint64_t bytes = 0;
+
+    /// The time spent replaying in seconds
+    double seconds = 0.0;
+
+    /// The events replayed per second
+    auto events_per_second() const -> double
+    {
+        return seconds > 0.0 ? events / seconds : 0.0;
+    }
+
+    /// The payload bytes replayed per second
+    auto bytes_per_second() const -> double
+    {
+        return seconds > 0.0 ? bytes / seconds : 0.0;
+    }
+};
+
+/// Feed the events of the encoded log to the handler as fast as possible,
+/// ignoring their times. The payloads are not copied. Returns the
+/// throughput of the handler, which makes a replay a benchmark of the
+/// component on real inputs.
+inline auto replay(std::string_view log,
+                   const std::function<void(const event_view&)>& handler)
+    -> tl::expected<replay_stats, std::string>
+{
+    replay_stats stats;
+    auto start = std::chrono::steady_clock::now();
+    auto result = for_each_event(log,
+                                 [&](const event_view& event)
+                                 {
+                                     handler(event);
+                                     stats.bytes += event.payload.size();
+                                     return true;
+                                 });
+    auto stop = std::chrono::steady_clock::now();
+
+    if (!result)
+    {
+        return tl::make_unexpected(result.error());
+    }
+    stats.events = *result;
+    stats.seconds = std::chrono::duration<double>(stop - start).count();
+    return stats;
+}
+
+/// Return a comparator for event logs reporting the first differing event
+inline auto event_log_comparator() -> comparator
+{
+    return [](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        auto describe = [](const event_view& event)
+        {
+            std::string text = "channel " + std::to_string(event.channel) +
+                               " at time " + std::to_string(event.time) +
+                               " with payload ";
+            append_json_string(text, event.payload);
+            return text;
+        };
+
+        // Index the produced events, the payloads stay in the data
+        std::vector<event_view> events;
+        auto produced = for_each_event(data,
+                                       [&events](const event_view& event)
+                                       {
+                                           events.push_back(event);
+                                           return true;
+                                       });
+        if (!produced)
+        {
+            return tl::make_unexpected("produced " + produced.error());
+        }
+
+        // Walk the recording and stop at the first differing event
+        std::string description;
+        std::size_t index = 0;
+        auto recorded = for_each_event(
+            recording,
+            [&](const event_view& event)
+            {
+                if (index == events.size())
+                {
+                    description = "event " + std::to_string(index) + " " +
+                                  describe(event) + " is missing";
+                    return false;
+                }
+                const event_view& other = events[index];
+                if (other.channel != event.channel ||
+                    other.time != event.time ||
+                    other.payload != event.payload)
+                {
+                    description = "event " + std::to_string(index) + " is " +
+                                  describe(other) + ", the recording has " +
+                                  describe(event);
+                    return false;
+                }
+                ++index;
+                return true;
+            });
+        if (!recorded)
+        {
+            return tl::make_unexpected(recorded.error());
+        }
+        if (description.empty())
+        {
+            description = std::to_string(events.size() - index) +
+                          " event(s) not in the recording";
+        }
+        return tl::make_unexpected(description);
+    };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "name_provider.hpp"
+
+namespace datarecorder
+{
+
+/// Return a name provider that returns "<test suite>_<test name>" of the
+/// running Google Test test, or nothing outside a test
+inline auto gtest_name_provider() -> name_provider
+{
+    return []() -> std::optional<std::string>
+    {
+        auto* test_info =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        if (test_info == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        std::string test_case = test_info->test_case_name();
+        std::string test_name = test_info->name();
+        if (test_case.empty() || test_name.empty())
+        {
+            return std::nullopt;
+        }
+        return test_case + "_" + test_name;
+    };
+}
+
+}
\ No newline at end of file
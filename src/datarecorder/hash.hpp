@@ -0,0 +1,43 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace datarecorder
+{
+
+/// The FNV-1a offset basis i.e. the hash of no data
+constexpr std::uint64_t fnv1a_basis = 14695981039346656037ULL;
+
+/// Compute the 64 bit FNV-1a hash of the data. Pass a previous hash to
+/// continue hashing from it.
+inline auto fnv1a_64(std::string_view data, std::uint64_t hash = fnv1a_basis)
+    -> std::uint64_t
+{
+    for (char c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// Return the hash as 16 lower case hex digits
+inline auto to_hex(std::uint64_t hash) -> std::string
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        hex[15 - i] = digits[(hash >> (4 * i)) & 0xf];
+    }
+    return hex;
+}
+
+}
\ No newline at end of file
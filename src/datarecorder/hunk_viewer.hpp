@@ -0,0 +1,149 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "diff.hpp"
+#include "json_string.hpp"
+
+namespace datarecorder
+{
+
+/// Append the hunks as a JSON array. Each hunk is an object with the line
+/// indexes ("r", "m"), line counts ("rc", "mc"), byte offsets ("ro", "mo"),
+/// whether it is a moved block ("mv"), the operation of each line ("ops")
+/// and the lines themselves ("lines").
+inline void append_hunks_json(std::string& output,
+                              const std::vector<diff_hunk>& hunks)
+{
+    output += "[";
+    for (std::size_t i = 0; i < hunks.size(); ++i)
+    {
+        const auto& hunk = hunks[i];
+        output += i == 0 ? "\n" : ",\n";
+        output += "{\"r\": " + std::to_string(hunk.recording_line) +
+                  ", \"rc\": " + std::to_string(hunk.recording_count) +
+                  ", \"ro\": " + std::to_string(hunk.recording_offset) +
+                  ", \"m\": " + std::to_string(hunk.mismatch_line) +
+                  ", \"mc\": " + std::to_string(hunk.mismatch_count) +
+                  ", \"mo\": " + std::to_string(hunk.mismatch_offset) +
+                  ", \"mv\": " + (hunk.moved ? "true" : "false") +
+                  ", \"ops\": \"";
+        for (const auto& line : hunk.lines)
+        {
+            output += line.op;
+        }
+        output += "\", \"lines\": [";
+        for (std::size_t j = 0; j < hunk.lines.size(); ++j)
+        {
+            if (j != 0)
+            {
+                output += ", ";
+            }
+            append_json_string(output, hunk.lines[j].text);
+        }
+        output += "]}";
+    }
+    output += "]";
+}
+
+/// The JavaScript function hunk_header(hunk) returning the header line of a
+/// hunk from append_hunks_json(), like hunk_header() in diff.hpp. It is
+/// shared by the pages showing hunks.
+inline auto hunk_header_js() -> const char*
+{
+    return R"js(function hunk_header(hunk) {
+    if (hunk.mv) {
+        return "@@ moved lines " + (hunk.r + 1) + "-" + (hunk.r + hunk.rc) +
+            " to " + (hunk.m + 1) + " @@";
+    }
+    return "@@ -" + (hunk.r + 1) + "," + hunk.rc + " +" + (hunk.m + 1) +
+        "," + hunk.mc + " @@";
+}
+)js";
+}
+
+/// The page written next to a hunk side file. The hunks are flattened into
+/// rows and only the rows in the visible region are rendered, so the page
+/// stays responsive no matter how large the diff is.
+///
+/// The side file is expected to be called "recording_diff.hunks.js" and to
+/// assign the window.datarecorder_hunks object.
+inline auto hunk_viewer_html() -> std::string
+{
+    return std::string(R"html(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>datarecorder diff</title>
+<style>
+body { font-family: sans-serif; margin: 0; }
+#header { padding: 0.5em 1em; border-bottom: 1px solid #ccc; }
+#viewport { position: absolute; top: 5em; bottom: 0; left: 0; right: 0;
+            overflow: auto; }
+#rows { position: absolute; left: 0; right: 0; }
+.row { height: 18px; line-height: 18px; font-family: monospace;
+       white-space: pre; padding-left: 1em; }
+.del { background: #fdd; }
+.add { background: #dfd; }
+.info { color: #666; background: #eee; }
+</style>
+</head>
+<body>
+<div id="header"><pre id="summary">Loading...</pre></div>
+<div id="viewport"><div id="spacer"></div><div id="rows"></div></div>
+<script>
+)html") + hunk_header_js() + R"html(var row_height = 18;
+var rows = [];
+function flatten(hunks) {
+    hunks.forEach(function(hunk) {
+        rows.push(["info", hunk_header(hunk) + " (byte " + hunk.ro + " / " +
+            hunk.mo + ")"]);
+        for (var i = 0; i < hunk.lines.length; ++i) {
+            var op = hunk.ops[i];
+            rows.push([op == "-" ? "del" : op == "+" ? "add" : "",
+                op + " " + hunk.lines[i]]);
+        }
+    });
+}
+function render() {
+    var viewport = document.getElementById("viewport");
+    var first = Math.floor(viewport.scrollTop / row_height);
+    var count = Math.ceil(viewport.clientHeight / row_height) + 20;
+    var container = document.getElementById("rows");
+    container.style.top = (first * row_height) + "px";
+    container.textContent = "";
+    for (var i = first; i < Math.min(rows.length, first + count); ++i) {
+        var row = document.createElement("div");
+        row.className = "row " + rows[i][0];
+        row.textContent = rows[i][1];
+        container.appendChild(row);
+    }
+}
+function load() {
+    var data = window.datarecorder_hunks;
+    document.getElementById("summary").textContent =
+        "recording: " + data.recording_path + " (" + data.recording_size +
+        " bytes)\nproduced:  " + data.mismatch_path + " (" +
+        data.mismatch_size + " bytes), " + data.hunks.length + " hunk(s)";
+    flatten(data.hunks);
+    document.getElementById("spacer").style.height =
+        (rows.length * row_height) + "px";
+    document.getElementById("viewport").addEventListener("scroll", render);
+    window.addEventListener("resize", render);
+    render();
+}
+</script>
+<script src="recording_diff.hunks.js" defer onload="load()"></script>
+</body>
+</html>
+)html";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace datarecorder
+{
+
+/// Append the data as a quoted JSON string to the output. The result can also
+/// be embedded in a HTML script element since "</" is escaped as well.
+inline void append_json_string(std::string& output, std::string_view data)
+{
+    output += '"';
+    char previous = 0;
+    for (char c : data)
+    {
+        switch (c)
+        {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        case '/':
+            output += previous == '<' ? "\\/" : "/";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                              static_cast<unsigned char>(c));
+                output += escaped;
+            }
+            else
+            {
+                output += c;
+            }
+        }
+        previous = c;
+    }
+    output += '"';
+}
+
+}
\ No newline at end of file
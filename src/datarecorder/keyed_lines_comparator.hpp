@@ -0,0 +1,205 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "comparator.hpp"
+#include "hash.hpp"
+#include "json_string.hpp"
+#include "parallel_for.hpp"
+#include "unordered_lines_comparator.hpp"
+
+namespace datarecorder
+{
+
+/// Returns the key of a line e.g. the flow id of a trace line. The returned
+/// view must point into the line.
+using key_extractor = std::function<std::string_view(std::string_view line)>;
+
+/// Return a key extractor that returns the field with the index, where
+/// fields are separated by the separator. Lines with fewer fields have the
+/// empty key.
+inline auto field_key(std::size_t index, char separator = ' ')
+    -> key_extractor
+{
+    return [index, separator](std::string_view line) -> std::string_view
+    {
+        std::size_t begin = 0;
+        for (std::size_t field = 0; field < index; ++field)
+        {
+            begin = line.find(separator, begin);
+            if (begin == std::string_view::npos)
+            {
+                return {};
+            }
+            ++begin;
+        }
+        std::size_t end = std::min(line.find(separator, begin), line.size());
+        return line.substr(begin, end - begin);
+    };
+}
+
+/// Return a comparator for interleaved traces where only the order of the
+/// lines with the same key matters. Both sides are split into a sequence of
+/// lines per key in a single pass, and the data matches if the sequences of
+/// every key are equal.
+///
+/// The sequences are compared in parallel by up to threads threads, zero
+/// uses the number of hardware threads. Small inputs are compared on the
+/// calling thread. On a mismatch the description holds the first
+/// divergence of each diverging key, at most max_keys keys.
+///
+/// Example:
+///     // Lines look like "flow=3 seq=17 ack"
+///     recorder.set_comparator(datarecorder::keyed_lines_comparator(
+///         datarecorder::field_key(0)));
+inline auto keyed_lines_comparator(key_extractor key,
+                                   std::size_t max_keys = 10,
+                                   std::size_t threads = 0) -> comparator
+{
+    return [key, max_keys, threads](std::string_view data,
+                                    std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        struct line
+        {
+            std::string_view text;
+            std::size_t number;
+        };
+
+        struct sequence
+        {
+            std::string_view key;
+            std::vector<line> produced;
+            std::vector<line> recorded;
+        };
+
+        struct key_hash
+        {
+            auto operator()(std::string_view key) const -> std::size_t
+            {
+                return static_cast<std::size_t>(fnv1a_64(key));
+            }
+        };
+
+        // Split both sides into the sequences of each key, in the order the
+        // keys first appear
+        std::vector<sequence> sequences;
+        std::unordered_map<std::string_view, std::size_t, key_hash> index;
+        auto split = [&](std::string_view side, bool produced)
+        {
+            std::size_t number = 0;
+            for_each_line(side,
+                          [&](std::string_view text)
+                          {
+                              std::string_view k = key(text);
+                              auto it = index.find(k);
+                              if (it == index.end())
+                              {
+                                  it = index.emplace(k, sequences.size()).first;
+                                  sequences.push_back({k, {}, {}});
+                              }
+                              auto& s = sequences[it->second];
+                              (produced ? s.produced : s.recorded)
+                                  .push_back({text, ++number});
+                          });
+        };
+        split(data, true);
+        split(recording, false);
+
+        // The first divergence of a key, or nothing if it does not diverge
+        auto compare = [](const sequence& s) -> std::string
+        {
+            auto quote = [](std::string_view text)
+            {
+                std::string quoted;
+                append_json_string(quoted, text);
+                return quoted;
+            };
+
+            std::size_t size = std::min(s.produced.size(), s.recorded.size());
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (s.produced[i].text != s.recorded[i].text)
+                {
+                    return "line " + std::to_string(s.produced[i].number) +
+                           " is " + quote(s.produced[i].text) +
+                           ", the recording has " +
+                           quote(s.recorded[i].text) + " at line " +
+                           std::to_string(s.recorded[i].number);
+                }
+            }
+            if (s.produced.size() > size)
+            {
+                return "line " + std::to_string(s.produced[size].number) +
+                       " " + quote(s.produced[size].text) +
+                       " is not in the recording";
+            }
+            if (s.recorded.size() > size)
+            {
+                return "line " + std::to_string(s.recorded[size].number) +
+                       " " + quote(s.recorded[size].text) +
+                       " of the recording is missing";
+            }
+            return {};
+        };
+
+        std::vector<std::string> divergences(sequences.size());
+
+        // Small inputs are compared on the calling thread
+        std::size_t workers = threads;
+        if (data.size() + recording.size() < (1U << 16))
+        {
+            workers = 1;
+        }
+        parallel_for(sequences.size(), workers, [&](std::size_t i)
+                     { divergences[i] = compare(sequences[i]); });
+
+        std::string description;
+        std::size_t diverging = 0;
+        for (std::size_t i = 0; i < sequences.size(); ++i)
+        {
+            if (divergences[i].empty())
+            {
+                continue;
+            }
+            if (diverging++ < max_keys)
+            {
+                description += "\n  key ";
+                append_json_string(description, sequences[i].key);
+                description += ": " + divergences[i];
+            }
+        }
+
+        if (diverging == 0)
+        {
+            return {};
+        }
+        if (diverging > max_keys)
+        {
+            description +=
+                "\n  ... " + std::to_string(diverging - max_keys) + " more";
+        }
+        return tl::make_unexpected(std::to_string(diverging) +
+                                   " key(s) diverge:" + description);
+    };
+}
+
+}
\ No newline at end of file
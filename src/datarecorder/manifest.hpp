@@ -0,0 +1,171 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "hash.hpp"
+#include "parallel_for.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// A recording in a manifest
+struct manifest_entry
+{
+    /// The path relative to the recording directory, with "/" separators
+    std::string path;
+
+    /// The size in bytes
+    std::uint64_t size = 0;
+
+    /// The FNV-1a hash of the content
+    std::uint64_t hash = 0;
+};
+
+/// Return the paths of all files below the directory relative to it, with
+/// "/" separators and sorted
+inline auto list_recordings(const std::filesystem::path& dir)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> paths;
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator(dir))
+    {
+        if (entry.is_regular_file())
+        {
+            paths.push_back(
+                entry.path().lexically_relative(dir).generic_string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+/// Hash all files below the directory on threads threads, zero uses the
+/// number of hardware threads
+inline auto make_manifest(const std::filesystem::path& dir,
+                          std::size_t threads = 0)
+    -> std::vector<manifest_entry>
+{
+    std::vector<std::string> paths = list_recordings(dir);
+    std::vector<manifest_entry> manifest(paths.size());
+    parallel_for(paths.size(), threads,
+                 [&](std::size_t i)
+                 {
+                     std::string data = read_binary_file(dir / paths[i]);
+                     manifest[i].path = paths[i];
+                     manifest[i].size = data.size();
+                     manifest[i].hash = fnv1a_64(data);
+                 });
+    return manifest;
+}
+
+/// Format the manifest with one "<hash> <size> <path>" line per recording
+inline auto format_manifest(const std::vector<manifest_entry>& manifest)
+    -> std::string
+{
+    std::string output;
+    for (const auto& entry : manifest)
+    {
+        output += to_hex(entry.hash) + " " + std::to_string(entry.size) +
+                  " " + entry.path + "\n";
+    }
+    return output;
+}
+
+/// Parse a manifest written by format_manifest()
+inline auto parse_manifest(std::string_view text)
+    -> tl::expected<std::vector<manifest_entry>, std::string>
+{
+    std::vector<manifest_entry> manifest;
+    std::size_t line_number = 0;
+    while (!text.empty())
+    {
+        ++line_number;
+        std::size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::size_t first = line.find(' ');
+        std::size_t second = first == std::string_view::npos
+                                 ? first
+                                 : line.find(' ', first + 1);
+        if (first != 16 || second == std::string_view::npos)
+        {
+            return tl::make_unexpected("invalid manifest line " +
+                                       std::to_string(line_number));
+        }
+
+        manifest_entry entry;
+        std::string hash(line.substr(0, 16));
+        std::string size(line.substr(first + 1, second - first - 1));
+        char* hash_end = nullptr;
+        char* size_end = nullptr;
+        entry.hash = std::strtoull(hash.c_str(), &hash_end, 16);
+        entry.size = std::strtoull(size.c_str(), &size_end, 10);
+        entry.path = std::string(line.substr(second + 1));
+        if (*hash_end != '\0' || size.empty() || *size_end != '\0' ||
+            entry.path.empty())
+        {
+            return tl::make_unexpected("invalid manifest line " +
+                                       std::to_string(line_number));
+        }
+        manifest.push_back(std::move(entry));
+    }
+    return manifest;
+}
+
+/// Compare the recordings with an expected manifest. Returns one line per
+/// problem i.e. a changed, missing or unexpected recording.
+inline auto compare_manifests(const std::vector<manifest_entry>& expected,
+                              const std::vector<manifest_entry>& actual)
+    -> std::vector<std::string>
+{
+    std::map<std::string, const manifest_entry*> entries;
+    for (const auto& entry : actual)
+    {
+        entries[entry.path] = &entry;
+    }
+
+    std::vector<std::string> problems;
+    for (const auto& entry : expected)
+    {
+        auto it = entries.find(entry.path);
+        if (it == entries.end())
+        {
+            problems.push_back("missing: " + entry.path);
+            continue;
+        }
+        if (it->second->hash != entry.hash || it->second->size != entry.size)
+        {
+            problems.push_back("changed: " + entry.path);
+        }
+        entries.erase(it);
+    }
+    for (const auto& entry : entries)
+    {
+        problems.push_back("unexpected: " + entry.first);
+    }
+    return problems;
+}
+
+}
\ No newline at end of file
@@ -25,6 +25,9 @@ struct mismatch_info
 
     /// Recording path (this is where the recording is stored)
     std::filesystem::path recording_path;
+
+    /// Description of the difference if found by a comparator
+    std::string description;
 };
 
 }
\ No newline at end of file
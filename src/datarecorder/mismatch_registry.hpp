@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "hash.hpp"
+#include "mismatch_info.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// Return the fingerprint of a mismatch i.e. the hash of the recording and
+/// the produced data. Identical mismatches in different tests share the
+/// fingerprint.
+inline auto mismatch_fingerprint(const mismatch_info& mismatch)
+    -> std::uint64_t
+{
+    std::uint64_t hash = fnv1a_64(mismatch.recording_data);
+
+    // Include the size so moving bytes between the two does not collide
+    std::string size = std::to_string(mismatch.recording_data.size());
+    hash = fnv1a_64(size, fnv1a_64({"\0", 1}, hash));
+
+    return fnv1a_64(mismatch.mismatch_data, hash);
+}
+
+/// Keeps track of the artifacts written for each mismatch fingerprint, such
+/// that a repeated mismatch can point at the existing artifacts instead of
+/// writing them again.
+///
+/// The registry always covers the current process. With enable_cache() the
+/// fingerprints are also stored in the temp directory so later runs reuse
+/// artifacts that still exist.
+class mismatch_registry
+{
+public:
+    /// The process-wide registry
+    static auto instance() -> mismatch_registry&
+    {
+        static mismatch_registry instance;
+        return instance;
+    }
+
+    /// Store the fingerprints in the cache directory as well. The default
+    /// cache directory is /tmp/cppmismatch-cache.
+    void enable_cache(std::filesystem::path cache_dir =
+                          std::filesystem::temp_directory_path() /
+                          "cppmismatch-cache")
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cache_dir = std::move(cache_dir);
+    }
+
+    /// Return the artifact path of a fingerprint if the artifact still exists
+    auto find(std::uint64_t fingerprint) -> std::optional<std::filesystem::path>
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_artifacts.find(fingerprint);
+        if (it != m_artifacts.end() && std::filesystem::exists(it->second))
+        {
+            return it->second;
+        }
+
+        if (!m_cache_dir)
+        {
+            return std::nullopt;
+        }
+
+        std::filesystem::path entry = *m_cache_dir / to_hex(fingerprint);
+        if (!std::filesystem::exists(entry))
+        {
+            return std::nullopt;
+        }
+
+        std::filesystem::path artifact = read_file(entry);
+        if (!std::filesystem::exists(artifact))
+        {
+            return std::nullopt;
+        }
+
+        m_artifacts[fingerprint] = artifact;
+        return artifact;
+    }
+
+    /// Register the artifact path written for the fingerprint
+    void insert(std::uint64_t fingerprint,
+                const std::filesystem::path& artifact)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_artifacts[fingerprint] = artifact;
+
+        if (m_cache_dir)
+        {
+            // Runs in other processes may read the entry at any time
+            write_file_atomic(*m_cache_dir / to_hex(fingerprint),
+                              artifact.string());
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::uint64_t, std::filesystem::path> m_artifacts;
+    std::optional<std::filesystem::path> m_cache_dir;
+};
+
+}
\ No newline at end of file
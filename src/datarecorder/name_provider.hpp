@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace datarecorder
+{
+
+/// Returns the name of the current test, or nothing if it is not known. The
+/// recording filename is derived from the name if it is not set explicitly.
+using name_provider = std::function<std::optional<std::string>()>;
+
+/// Return a name provider that always returns the name
+inline auto explicit_name(std::string name) -> name_provider
+{
+    return [name = std::move(name)]() -> std::optional<std::string>
+    { return name; };
+}
+
+/// Sets the name returned by scoped_name_provider() on the current thread
+/// while it is alive. Scopes can be nested, the innermost name is used.
+///
+/// Example:
+///     for (const auto& scenario : scenarios)
+///     {
+///         datarecorder::scoped_name name("bench_" + scenario.name);
+///         recorder.record(run(scenario));
+///     }
+class scoped_name
+{
+public:
+    /// Constructor
+    explicit scoped_name(std::string name) : m_previous(std::move(slot()))
+    {
+        slot() = std::move(name);
+    }
+
+    /// Destructor
+    ~scoped_name()
+    {
+        slot() = std::move(m_previous);
+    }
+
+    scoped_name(const scoped_name&) = delete;
+    scoped_name& operator=(const scoped_name&) = delete;
+
+    /// The innermost name on the current thread if any
+    static auto current() -> std::optional<std::string>
+    {
+        return slot();
+    }
+
+private:
+    static auto slot() -> std::optional<std::string>&
+    {
+        thread_local std::optional<std::string> name;
+        return name;
+    }
+
+private:
+    std::optional<std::string> m_previous;
+};
+
+/// Return a name provider that returns the scoped_name of the calling
+/// thread
+inline auto scoped_name_provider() -> name_provider
+{
+    return [] { return scoped_name::current(); };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,361 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <verify/verify.hpp>
+
+#include "pattern.hpp"
+
+namespace datarecorder
+{
+
+/// A pipeline of replacements used to scrub volatile parts like timestamps,
+/// addresses, PIDs and temporary paths from data before it is compared with
+/// or stored as a recording.
+///
+/// The rules are compiled when added and applied in a single pass over the
+/// data. At every position the rules are tried in the order they were added
+/// and the first rule that matches replaces the matched text. Trying a rule
+/// scans ahead as far as its pattern can still match, see pattern, so the
+/// pass is linear for rules with short matches and quadratic in the worst
+/// case. A table of the
+/// characters each rule can start with means most positions are skipped
+/// without trying any rule, and if only one character can start a match
+/// the pass jumps between its occurrences with memchr.
+///
+/// Example:
+///     datarecorder::normalizer normalizer;
+///     normalizer.replace("/tmp/build-42", "<tmp>")
+///         .replace_pattern("0x[0-9a-f]+", "<address>")
+///         .mask_numbers();
+///
+///     recorder.set_normalizer(normalizer);
+class normalizer
+{
+public:
+    /// Replace every occurrence of the literal text
+    auto replace(std::string literal, std::string replacement) -> normalizer&
+    {
+        VERIFY(!literal.empty(), "Literal must not be empty");
+
+        rule r;
+        r.type = rule_type::literal;
+        r.literal = std::move(literal);
+        r.replacement = std::move(replacement);
+        add(std::move(r));
+        return *this;
+    }
+
+    /// Replace every match of the pattern, see pattern for the syntax
+    auto replace_pattern(std::string_view expression, std::string replacement)
+        -> normalizer&
+    {
+        rule r;
+        r.type = rule_type::pattern;
+        r.compiled.emplace(expression);
+        VERIFY(!r.compiled->matches_empty(),
+               "Pattern must not match the empty string", expression);
+        r.replacement = std::move(replacement);
+        add(std::move(r));
+        return *this;
+    }
+
+    /// Replace every match of the precompiled pattern, for instance a
+    /// constexpr pattern compiled at compile time
+    auto replace_pattern(const pattern& compiled, std::string replacement)
+        -> normalizer&
+    {
+        VERIFY(!compiled.matches_empty(),
+               "Pattern must not match the empty string");
+
+        rule r;
+        r.type = rule_type::pattern;
+        r.compiled = compiled;
+        r.replacement = std::move(replacement);
+        add(std::move(r));
+        return *this;
+    }
+
+    /// Replace every number i.e. decimal numbers with an optional fraction
+    /// and exponent, and hexadecimal numbers starting with "0x". Digits that
+    /// are part of a word like "test1" are not masked.
+    auto mask_numbers(std::string replacement = "<number>") -> normalizer&
+    {
+        rule r;
+        r.type = rule_type::number;
+        r.replacement = std::move(replacement);
+        add(std::move(r));
+        return *this;
+    }
+
+    /// Apply the rules to the data. The normalized data is passed to the
+    /// sink as consecutive pieces, which are either views into the data or
+    /// the replacements. The sink returns false to stop early.
+    ///
+    /// Returns false if the sink stopped the pass.
+    template <class Sink>
+    auto apply(std::string_view data, Sink&& sink) const -> bool
+    {
+        std::size_t unchanged = 0;
+        std::size_t i = 0;
+        while (i < data.size())
+        {
+            if (m_single_first)
+            {
+                // Jump to the only character a rule can start with
+                const void* next = std::memchr(data.data() + i, m_first_char,
+                                               data.size() - i);
+                if (next == nullptr)
+                {
+                    break;
+                }
+                i = static_cast<const char*>(next) - data.data();
+            }
+
+            const auto c = static_cast<unsigned char>(data[i]);
+            if (!m_first[c])
+            {
+                ++i;
+                continue;
+            }
+
+            std::size_t length = 0;
+            const rule* matched = nullptr;
+            for (const auto& r : m_rules)
+            {
+                length = r.first[c] ? match(r, data, i) : 0;
+                if (length > 0)
+                {
+                    matched = &r;
+                    break;
+                }
+            }
+
+            if (matched == nullptr)
+            {
+                ++i;
+                continue;
+            }
+
+            if (i > unchanged &&
+                !sink(data.substr(unchanged, i - unchanged)))
+            {
+                return false;
+            }
+            if (!sink(std::string_view(matched->replacement)))
+            {
+                return false;
+            }
+            i += length;
+            unchanged = i;
+        }
+
+        if (data.size() > unchanged)
+        {
+            return sink(data.substr(unchanged));
+        }
+        return true;
+    }
+
+    /// Return the normalized data
+    auto apply(std::string_view data) const -> std::string
+    {
+        std::string normalized;
+        normalized.reserve(data.size());
+        apply(data,
+              [&normalized](std::string_view piece)
+              {
+                  normalized.append(piece.data(), piece.size());
+                  return true;
+              });
+        return normalized;
+    }
+
+    /// Return true if the normalized data equals the expected data. The
+    /// normalized data is compared piece by piece and never materialized.
+    auto equal(std::string_view data, std::string_view expected) const -> bool
+    {
+        std::size_t position = 0;
+        bool equal = apply(
+            data,
+            [&](std::string_view piece)
+            {
+                if (piece.size() > expected.size() - position ||
+                    std::memcmp(piece.data(), expected.data() + position,
+                                piece.size()) != 0)
+                {
+                    return false;
+                }
+                position += piece.size();
+                return true;
+            });
+        return equal && position == expected.size();
+    }
+
+    /// Return true if no rules were added
+    auto empty() const -> bool
+    {
+        return m_rules.empty();
+    }
+
+private:
+    enum class rule_type
+    {
+        literal,
+        pattern,
+        number
+    };
+
+    struct rule
+    {
+        rule_type type;
+        std::string literal;
+        std::optional<pattern> compiled;
+        std::string replacement;
+
+        /// The characters a match can start with
+        std::array<bool, 256> first{};
+    };
+
+    void add(rule r)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            switch (r.type)
+            {
+            case rule_type::literal:
+                r.first[c] = static_cast<unsigned char>(r.literal[0]) == c;
+                break;
+            case rule_type::pattern:
+                r.first[c] = r.compiled->can_start_with(c);
+                break;
+            case rule_type::number:
+                r.first[c] = c >= '0' && c <= '9';
+                break;
+            }
+            m_first[c] = m_first[c] || r.first[c];
+        }
+        m_rules.push_back(std::move(r));
+
+        std::size_t first_count = 0;
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            if (m_first[c])
+            {
+                ++first_count;
+                m_first_char = static_cast<unsigned char>(c);
+            }
+        }
+        m_single_first = first_count == 1;
+    }
+
+    static auto match(const rule& r, std::string_view data, std::size_t i)
+        -> std::size_t
+    {
+        switch (r.type)
+        {
+        case rule_type::literal:
+            return data.compare(i, r.literal.size(), r.literal) == 0
+                       ? r.literal.size()
+                       : 0;
+        case rule_type::pattern:
+        {
+            std::ptrdiff_t length = r.compiled->match(data.substr(i));
+            return length > 0 ? length : 0;
+        }
+        case rule_type::number:
+            return match_number(data, i);
+        }
+        return 0;
+    }
+
+    static auto match_number(std::string_view data, std::size_t i)
+        -> std::size_t
+    {
+        auto digit = [&data](std::size_t j)
+        { return j < data.size() && data[j] >= '0' && data[j] <= '9'; };
+        auto hex = [&data, &digit](std::size_t j)
+        {
+            return digit(j) ||
+                   (j < data.size() && ((data[j] >= 'a' && data[j] <= 'f') ||
+                                        (data[j] >= 'A' && data[j] <= 'F')));
+        };
+
+        // Digits inside a word are not a number
+        if (i > 0)
+        {
+            char previous = data[i - 1];
+            if ((previous >= 'a' && previous <= 'z') ||
+                (previous >= 'A' && previous <= 'Z') || previous == '_' ||
+                (previous >= '0' && previous <= '9'))
+            {
+                return 0;
+            }
+        }
+
+        std::size_t j = i;
+        if (data[j] == '0' && j + 2 < data.size() &&
+            (data[j + 1] == 'x' || data[j + 1] == 'X') && hex(j + 2))
+        {
+            j += 2;
+            while (hex(j))
+            {
+                ++j;
+            }
+            return j - i;
+        }
+
+        while (digit(j))
+        {
+            ++j;
+        }
+        if (j < data.size() && data[j] == '.' && digit(j + 1))
+        {
+            ++j;
+            while (digit(j))
+            {
+                ++j;
+            }
+        }
+        if (j < data.size() && (data[j] == 'e' || data[j] == 'E'))
+        {
+            std::size_t k = j + 1;
+            if (k < data.size() && (data[k] == '+' || data[k] == '-'))
+            {
+                ++k;
+            }
+            if (digit(k))
+            {
+                j = k;
+                while (digit(j))
+                {
+                    ++j;
+                }
+            }
+        }
+        return j - i;
+    }
+
+private:
+    std::vector<rule> m_rules;
+
+    /// The characters any rule can start with
+    std::array<bool, 256> m_first{};
+
+    /// The only character any rule can start with if m_single_first
+    unsigned char m_first_char = 0;
+    bool m_single_first = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "comparator.hpp"
+
+namespace datarecorder
+{
+
+/// The tolerance used when comparing numbers. Two numbers are equal if any
+/// of the tolerances is met. The default tolerance requires exact equality.
+struct tolerance
+{
+    /// Maximum absolute difference
+    double absolute = 0.0;
+
+    /// Maximum difference relative to the largest magnitude of the two
+    double relative = 0.0;
+
+    /// Maximum distance in units in the last place
+    std::uint64_t ulps = 0;
+};
+
+/// Return the distance between two doubles in units in the last place
+inline auto ulp_distance(double a, double b) -> std::uint64_t
+{
+    static_assert(sizeof(double) == sizeof(std::int64_t), "64 bit doubles");
+
+    if (std::isnan(a) || std::isnan(b))
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    // Map the doubles to integers that are ordered like the doubles
+    auto ordered = [](double value)
+    {
+        std::int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits
+                        : bits;
+    };
+    std::int64_t x = ordered(a);
+    std::int64_t y = ordered(b);
+    return x > y ? std::uint64_t(x) - std::uint64_t(y)
+                 : std::uint64_t(y) - std::uint64_t(x);
+}
+
+/// Return the distance between two floats in units in the last place
+inline auto ulp_distance(float a, float b) -> std::uint64_t
+{
+    static_assert(sizeof(float) == sizeof(std::int32_t), "32 bit floats");
+
+    if (std::isnan(a) || std::isnan(b))
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    auto ordered = [](float value)
+    {
+        std::int32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        constexpr std::int64_t min = std::numeric_limits<std::int32_t>::min();
+        return bits < 0 ? min - bits : std::int64_t{bits};
+    };
+    std::int64_t x = ordered(a);
+    std::int64_t y = ordered(b);
+    return x > y ? std::uint64_t(x - y) : std::uint64_t(y - x);
+}
+
+/// Return true if the two numbers are equal within the tolerance
+inline auto within_tolerance(double a, double b, const tolerance& tolerance)
+    -> bool
+{
+    if (a == b)
+    {
+        return true;
+    }
+    double difference = std::fabs(a - b);
+    if (difference <= tolerance.absolute)
+    {
+        return true;
+    }
+    if (difference <=
+        tolerance.relative * std::max(std::fabs(a), std::fabs(b)))
+    {
+        return true;
+    }
+    return ulp_distance(a, b) <= tolerance.ulps;
+}
+
+/// Return the number as text that parses back to the same value
+inline auto to_string_exact(double value) -> std::string
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+/// Return the integer as text
+inline auto to_string_exact(std::int64_t value) -> std::string
+{
+    return std::to_string(value);
+}
+
+/// Return the length of the number starting at the position, or zero if no
+/// number starts there. A number is an optionally signed decimal number with
+/// an optional fraction and exponent that is not part of a word.
+inline auto number_length(std::string_view data, std::size_t i) -> std::size_t
+{
+    auto digit = [&data](std::size_t j)
+    { return j < data.size() && data[j] >= '0' && data[j] <= '9'; };
+
+    if (i > 0)
+    {
+        char previous = data[i - 1];
+        if (digit(i - 1) || previous == '_' || previous == '.' ||
+            (previous >= 'a' && previous <= 'z') ||
+            (previous >= 'A' && previous <= 'Z'))
+        {
+            return 0;
+        }
+    }
+
+    std::size_t j = i;
+    if (j < data.size() && (data[j] == '-' || data[j] == '+'))
+    {
+        ++j;
+    }
+    std::size_t digits = 0;
+    while (digit(j))
+    {
+        ++j;
+        ++digits;
+    }
+    // The point belongs to the number only if a digit follows, so the
+    // period ending a sentence like "took 5." is text
+    if (j < data.size() && data[j] == '.' && digit(j + 1))
+    {
+        ++j;
+        while (digit(j))
+        {
+            ++j;
+            ++digits;
+        }
+    }
+    if (digits == 0)
+    {
+        return 0;
+    }
+    if (j < data.size() && (data[j] == 'e' || data[j] == 'E'))
+    {
+        std::size_t k = j + 1;
+        if (k < data.size() && (data[k] == '+' || data[k] == '-'))
+        {
+            ++k;
+        }
+        if (digit(k))
+        {
+            j = k;
+            while (digit(j))
+            {
+                ++j;
+            }
+        }
+    }
+    return j - i;
+}
+
+/// Parse a number found with number_length(). Returns nothing if the
+/// number is out of the range of a double, such as 1e400.
+inline auto parse_number(std::string_view number) -> std::optional<double>
+{
+    // from_chars does not accept a leading plus
+    if (!number.empty() && number[0] == '+')
+    {
+        number.remove_prefix(1);
+    }
+
+    double value = 0.0;
+#if defined(__cpp_lib_to_chars)
+    auto result =
+        std::from_chars(number.data(), number.data() + number.size(), value);
+    if (result.ec != std::errc{})
+    {
+        return std::nullopt;
+    }
+#else
+    // Fall back to strtod where floating point from_chars is missing
+    char buffer[128] = {};
+    std::memcpy(buffer, number.data(),
+                std::min(number.size(), sizeof(buffer) - 1));
+    errno = 0;
+    value = std::strtod(buffer, nullptr);
+    if (errno == ERANGE)
+    {
+        return std::nullopt;
+    }
+#endif
+    return value;
+}
+
+/// Return a comparator that compares numbers under the tolerance and all
+/// other text exactly. Both sides are tokenized in a single pass which stops
+/// at the first violating token.
+///
+/// Example:
+///     datarecorder::tolerance tolerance;
+///     tolerance.ulps = 4;
+///     recorder.set_comparator(datarecorder::numeric_comparator(tolerance));
+inline auto numeric_comparator(tolerance tolerance) -> comparator
+{
+    return [tolerance](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        std::size_t line = 1;
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < data.size() && j < recording.size())
+        {
+            std::size_t data_length = number_length(data, i);
+            std::size_t recording_length =
+                data_length > 0 ? number_length(recording, j) : 0;
+
+            if (data_length > 0 && recording_length > 0)
+            {
+                std::string_view a = data.substr(i, data_length);
+                std::string_view b = recording.substr(j, recording_length);
+                // Numbers out of range are compared as text
+                auto x = parse_number(a);
+                auto y = parse_number(b);
+                if (a != b &&
+                    (!x || !y || !within_tolerance(*x, *y, tolerance)))
+                {
+                    return tl::make_unexpected(
+                        "line " + std::to_string(line) + ": number " +
+                        std::string(a) + " differs from the recorded " +
+                        std::string(b) + " beyond the tolerance");
+                }
+                i += data_length;
+                j += recording_length;
+                continue;
+            }
+
+            if (data[i] != recording[j])
+            {
+                return tl::make_unexpected("line " + std::to_string(line) +
+                                           ": text differs");
+            }
+            if (data[i] == '\n')
+            {
+                ++line;
+            }
+            ++i;
+            ++j;
+        }
+
+        if (i < data.size() || j < recording.size())
+        {
+            return tl::make_unexpected("line " + std::to_string(line) +
+                                       ": data length differs");
+        }
+        return {};
+    };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace datarecorder
+{
+
+/// Call the function with every index in [0, count) on a pool of threads,
+/// zero threads uses the number of hardware threads. The indexes are handed
+/// out one at a time, so uneven work is balanced between the threads. The
+/// first exception thrown by the function is rethrown once all threads are
+/// done, the remaining indexes are then skipped.
+inline void parallel_for(std::size_t count, std::size_t threads,
+                         const std::function<void(std::size_t)>& function)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, count);
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&]
+    {
+        for (std::size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                function(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < threads; ++i)
+    {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,368 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include <verify/verify.hpp>
+
+namespace datarecorder
+{
+
+/// Report an invalid pattern. This is deliberately not constexpr, so an
+/// invalid pattern compiled at compile time is a compile error.
+inline void pattern_error(const char* message, std::string_view expression)
+{
+    VERIFY(false, message, expression);
+}
+
+/// A small regular expression subset for scrubbing recordings.
+///
+/// Supported syntax:
+///
+/// * Literal characters and escaped characters like "\." or "\\"
+/// * "." matching any character except a newline
+/// * The classes "\d", "\w", "\s" and their negations "\D", "\W", "\S"
+/// * Bracket expressions like "[a-f0-9_]" and "[^}]"
+/// * The quantifiers "?", "*" and "+"
+///
+/// Alternation, groups and anchors are not supported. A pattern has at most
+/// 63 atoms.
+///
+/// The pattern is compiled to a bit-parallel automaton where every atom is
+/// one bit of the state, so match() runs without backtracking and without
+/// allocations, in time linear in the characters it scans. It scans for as
+/// long as the state is alive, not only up to the match. find() restarts
+/// match() at every position a match can start at, so a search costs the
+/// sum of these scans: quadratic in the worst case, such as "a.*b" on a
+/// line of many "a"s, and linear when the scans are short. Since "." does
+/// not match a newline such a scan ends at the end of the line. Matches are
+/// leftmost-longest.
+///
+/// The compilation is constexpr, so patterns known up front are compiled to
+/// their transition tables by the compiler:
+///
+///     static constexpr datarecorder::pattern address("0x[0-9a-f]+");
+class pattern
+{
+public:
+    /// Compile the pattern
+    constexpr explicit pattern(std::string_view expression)
+    {
+        std::size_t atoms = 0;
+        std::size_t i = 0;
+        while (i < expression.size())
+        {
+            if (atoms >= 63)
+            {
+                pattern_error("Pattern has too many atoms", expression);
+            }
+
+            std::array<bool, 256> set{};
+            i = parse_atom(expression, i, set);
+
+            const std::uint64_t bit = std::uint64_t{1} << atoms;
+            for (std::size_t c = 0; c < 256; ++c)
+            {
+                if (set[c])
+                {
+                    m_char_mask[c] |= bit;
+                }
+            }
+
+            if (i < expression.size())
+            {
+                switch (expression[i])
+                {
+                case '?':
+                    m_skip_mask |= bit;
+                    ++i;
+                    break;
+                case '*':
+                    m_skip_mask |= bit;
+                    m_repeat_mask |= bit;
+                    ++i;
+                    break;
+                case '+':
+                    m_repeat_mask |= bit;
+                    ++i;
+                    break;
+                default:
+                    break;
+                }
+            }
+            ++atoms;
+        }
+
+        m_accept = std::uint64_t{1} << atoms;
+        m_start = closure(1);
+
+        // A single possible first character lets find() use memchr
+        std::size_t first_count = 0;
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            if (m_start & m_char_mask[c])
+            {
+                ++first_count;
+                m_first_char = static_cast<unsigned char>(c);
+            }
+        }
+        m_single_first_char = first_count == 1 && !(m_start & m_accept);
+    }
+
+    /// Return the length of the longest match starting at the beginning of
+    /// the data, or -1 if the pattern does not match there.
+    constexpr auto match(std::string_view data) const -> std::ptrdiff_t
+    {
+        std::uint64_t state = m_start;
+        std::ptrdiff_t longest = (state & m_accept) ? 0 : -1;
+
+        for (std::size_t i = 0; i < data.size() && state != 0; ++i)
+        {
+            state = step(state, static_cast<unsigned char>(data[i]));
+            if (state & m_accept)
+            {
+                longest = i + 1;
+            }
+        }
+        return longest;
+    }
+
+    /// Find the first non-empty match at or after the position. Returns the
+    /// position and length of the match, or std::string_view::npos as the
+    /// position if there is none.
+    auto find(std::string_view data, std::size_t position = 0) const
+        -> std::pair<std::size_t, std::size_t>
+    {
+        while (position < data.size())
+        {
+            if (m_single_first_char)
+            {
+                const void* next =
+                    std::memchr(data.data() + position, m_first_char,
+                                data.size() - position);
+                if (next == nullptr)
+                {
+                    break;
+                }
+                position = static_cast<const char*>(next) - data.data();
+            }
+            else if (!can_start_with(data[position]))
+            {
+                ++position;
+                continue;
+            }
+
+            std::ptrdiff_t length = match(data.substr(position));
+            if (length > 0)
+            {
+                return {position, static_cast<std::size_t>(length)};
+            }
+            ++position;
+        }
+        return {std::string_view::npos, 0};
+    }
+
+    /// Return true if a match can start with the character
+    constexpr auto can_start_with(unsigned char c) const -> bool
+    {
+        return (m_start & m_char_mask[c]) != 0;
+    }
+
+    /// Return true if the pattern matches the empty string
+    constexpr auto matches_empty() const -> bool
+    {
+        return (m_start & m_accept) != 0;
+    }
+
+private:
+    constexpr auto step(std::uint64_t state, unsigned char c) const
+        -> std::uint64_t
+    {
+        std::uint64_t matched = state & m_char_mask[c];
+        return closure((matched & m_repeat_mask) | (matched << 1));
+    }
+
+    constexpr auto closure(std::uint64_t state) const -> std::uint64_t
+    {
+        // Optional atoms can be skipped i.e. also enable the next atom
+        while (true)
+        {
+            std::uint64_t next = state | ((state & m_skip_mask) << 1);
+            if (next == state)
+            {
+                return state;
+            }
+            state = next;
+        }
+    }
+
+    static constexpr auto parse_atom(std::string_view expression,
+                                     std::size_t i, std::array<bool, 256>& set)
+        -> std::size_t
+    {
+        char c = expression[i];
+        if (c == '.')
+        {
+            for (std::size_t member = 0; member < 256; ++member)
+            {
+                set[member] = member != '\n';
+            }
+            return i + 1;
+        }
+        if (c == '\\')
+        {
+            if (i + 1 >= expression.size())
+            {
+                pattern_error("Pattern ends with an escape", expression);
+            }
+            add_escape(expression[i + 1], set);
+            return i + 2;
+        }
+        if (c == '[')
+        {
+            return parse_bracket(expression, i + 1, set);
+        }
+        if (c == '?' || c == '*' || c == '+')
+        {
+            pattern_error("Quantifier without atom", expression);
+        }
+        set[static_cast<unsigned char>(c)] = true;
+        return i + 1;
+    }
+
+    static constexpr auto parse_bracket(std::string_view expression,
+                                        std::size_t i,
+                                        std::array<bool, 256>& set)
+        -> std::size_t
+    {
+        bool negate = i < expression.size() && expression[i] == '^';
+        if (negate)
+        {
+            ++i;
+        }
+
+        bool first = true;
+        while (i < expression.size() && (first || expression[i] != ']'))
+        {
+            first = false;
+            unsigned char low = expression[i];
+            if (low == '\\' && i + 1 < expression.size())
+            {
+                // Escapes like \d add a class, others a literal
+                add_escape(expression[i + 1], set);
+                i += 2;
+                continue;
+            }
+            if (i + 2 < expression.size() && expression[i + 1] == '-' &&
+                expression[i + 2] != ']')
+            {
+                unsigned char high = expression[i + 2];
+                for (std::size_t c = low; c <= high; ++c)
+                {
+                    set[c] = true;
+                }
+                i += 3;
+                continue;
+            }
+            set[low] = true;
+            ++i;
+        }
+        if (i >= expression.size())
+        {
+            pattern_error("Unterminated bracket expression", expression);
+        }
+
+        if (negate)
+        {
+            for (std::size_t c = 0; c < 256; ++c)
+            {
+                set[c] = !set[c];
+            }
+        }
+        return i + 1;
+    }
+
+    static constexpr auto is_digit(std::size_t c) -> bool
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static constexpr auto is_word(std::size_t c) -> bool
+    {
+        return is_digit(c) || (c >= 'a' && c <= 'z') ||
+               (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    static constexpr auto is_space(std::size_t c) -> bool
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+               c == '\v';
+    }
+
+    static constexpr void add_escape(char escape, std::array<bool, 256>& set)
+    {
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            switch (escape)
+            {
+            case 'd':
+                set[c] = set[c] || is_digit(c);
+                break;
+            case 'D':
+                set[c] = set[c] || !is_digit(c);
+                break;
+            case 'w':
+                set[c] = set[c] || is_word(c);
+                break;
+            case 'W':
+                set[c] = set[c] || !is_word(c);
+                break;
+            case 's':
+                set[c] = set[c] || is_space(c);
+                break;
+            case 'S':
+                set[c] = set[c] || !is_space(c);
+                break;
+            case 'n':
+                set[c] = set[c] || c == '\n';
+                break;
+            case 't':
+                set[c] = set[c] || c == '\t';
+                break;
+            default:
+                set[c] = set[c] || c == static_cast<unsigned char>(escape);
+            }
+        }
+    }
+
+private:
+    /// For every character the atoms that accept it
+    std::array<std::uint64_t, 256> m_char_mask{};
+
+    /// Atoms that may be skipped i.e. "?" and "*"
+    std::uint64_t m_skip_mask = 0;
+
+    /// Atoms that may repeat i.e. "*" and "+"
+    std::uint64_t m_repeat_mask = 0;
+
+    /// The state before any character is consumed
+    std::uint64_t m_start = 0;
+
+    /// The accepting state
+    std::uint64_t m_accept = 0;
+
+    /// The only character a match can start with if m_single_first_char
+    unsigned char m_first_char = 0;
+    bool m_single_first_char = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "recorder.hpp"
+
+#include "datarecorder.hpp"
+
+namespace datarecorder
+{
+
+struct recorder::impl
+{
+    datarecorder data_recorder;
+};
+
+namespace
+{
+auto to_message(const tl::expected<void, poke::error>& result)
+    -> tl::expected<void, std::string>
+{
+    if (!result)
+    {
+        return tl::make_unexpected(result.error().message());
+    }
+    return {};
+}
+}
+
+recorder::recorder() : m_impl(std::make_unique<impl>())
+{
+}
+
+recorder::~recorder() = default;
+
+recorder::recorder(recorder&& other) noexcept = default;
+
+auto recorder::operator=(recorder&& other) noexcept -> recorder& = default;
+
+void recorder::set_recording_dir(const std::string& recording_dir)
+{
+    m_impl->data_recorder.set_recording_dir(recording_dir);
+}
+
+void recorder::set_recording_filename(const std::string& filename)
+{
+    m_impl->data_recorder.set_recording_filename(filename);
+}
+
+void recorder::set_comparator(comparator comparator)
+{
+    m_impl->data_recorder.set_comparator(std::move(comparator));
+}
+
+void recorder::set_inline_diff_limit(std::size_t bytes)
+{
+    m_impl->data_recorder.set_inline_diff_limit(bytes);
+}
+
+void recorder::enable_mismatch_cache()
+{
+    m_impl->data_recorder.enable_mismatch_cache();
+}
+
+void recorder::use_session()
+{
+    m_impl->data_recorder.use_session();
+}
+
+auto recorder::record(std::string_view data)
+    -> tl::expected<void, std::string>
+{
+    return to_message(m_impl->data_recorder.record(data));
+}
+
+auto recorder::record(const std::vector<std::string>& data)
+    -> tl::expected<void, std::string>
+{
+    return to_message(m_impl->data_recorder.record(data));
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "comparator.hpp"
+
+namespace datarecorder
+{
+
+/// A lightweight front for datarecorder, implemented in the compiled
+/// steinwurf::datarecorder_compiled library. Including this header does not
+/// pull in Google Test, poke, verify or the filesystem and stream headers,
+/// which keeps the compile time of test files low.
+///
+/// Errors are returned as the message of the poke::error the datarecorder
+/// would return. Programming errors, such as recording without a recording
+/// directory, are checked with VERIFY and abort like in datarecorder.
+///
+/// If the library is built without Google Test it is compiled with
+/// DATARECORDER_DISABLE_GTEST, which is then also defined for the code
+/// linking it, see datarecorder.hpp.
+///
+/// Example:
+///     datarecorder::recorder recorder;
+///     recorder.set_recording_dir("test/recordings");
+///     auto result = recorder.record("test data");
+///     EXPECT_TRUE(result) << result.error();
+class recorder
+{
+public:
+    /// Constructor
+    recorder();
+
+    /// Destructor
+    ~recorder();
+
+    /// Move constructor
+    recorder(recorder&& other) noexcept;
+
+    /// Move assignment
+    auto operator=(recorder&& other) noexcept -> recorder&;
+
+    /// See datarecorder::set_recording_dir()
+    void set_recording_dir(const std::string& recording_dir);
+
+    /// See datarecorder::set_recording_filename()
+    void set_recording_filename(const std::string& filename);
+
+    /// See datarecorder::set_comparator()
+    void set_comparator(comparator comparator);
+
+    /// See datarecorder::set_inline_diff_limit()
+    void set_inline_diff_limit(std::size_t bytes);
+
+    /// See datarecorder::enable_mismatch_cache()
+    void enable_mismatch_cache();
+
+    /// See datarecorder::use_session()
+    void use_session();
+
+    /// See datarecorder::record()
+    auto record(std::string_view data) -> tl::expected<void, std::string>;
+
+    /// See datarecorder::record()
+    auto record(const std::vector<std::string>& data)
+        -> tl::expected<void, std::string>;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "diff.hpp"
+#include "hash.hpp"
+
+namespace datarecorder
+{
+
+/// The operations of a delta
+enum class delta_op : std::uint8_t
+{
+    /// Copy a range of the base
+    copy = 'C',
+
+    /// Insert the bytes stored in the delta
+    insert = 'I'
+};
+
+/// Encode the target as a delta against the base. The delta is a list of
+/// operations copying line ranges of the base and inserting new bytes,
+/// found with diff_script(). Everything is stored little-endian:
+///
+///     "DRD1"
+///     varint base size, u64 FNV-1a hash of the base
+///     varint target size
+///     operations until the end:
+///         'C' varint offset, varint length
+///         'I' varint length, the bytes
+inline auto encode_delta(std::string_view base, std::string_view target)
+    -> std::string
+{
+    std::string delta;
+    delta.append("DRD1", 4);
+    append_varint(delta, base.size());
+    append_le(delta, fnv1a_64(base));
+    append_varint(delta, target.size());
+
+    auto a = split_lines(base);
+    auto b = split_lines(target);
+    std::string script = diff_script(a, b);
+
+    // Adjacent lines are merged into a single operation
+    std::size_t copy_offset = 0;
+    std::size_t copy_length = 0;
+    std::size_t insert_offset = 0;
+    std::size_t insert_length = 0;
+    auto flush = [&]
+    {
+        if (copy_length > 0)
+        {
+            delta += static_cast<char>(delta_op::copy);
+            append_varint(delta, copy_offset);
+            append_varint(delta, copy_length);
+            copy_length = 0;
+        }
+        if (insert_length > 0)
+        {
+            delta += static_cast<char>(delta_op::insert);
+            append_varint(delta, insert_length);
+            delta.append(target.substr(insert_offset, insert_length));
+            insert_length = 0;
+        }
+    };
+
+    std::size_t ai = 0;
+    std::size_t bi = 0;
+    for (char op : script)
+    {
+        if (op == ' ')
+        {
+            std::size_t offset = a[ai].data() - base.data();
+            if (insert_length > 0 || copy_offset + copy_length != offset)
+            {
+                flush();
+                copy_offset = offset;
+            }
+            copy_length += a[ai].size();
+            ++ai;
+            ++bi;
+        }
+        else if (op == '-')
+        {
+            ++ai;
+        }
+        else
+        {
+            if (copy_length > 0)
+            {
+                flush();
+                insert_offset = b[bi].data() - target.data();
+            }
+            if (insert_length == 0)
+            {
+                insert_offset = b[bi].data() - target.data();
+            }
+            insert_length += b[bi].size();
+            ++bi;
+        }
+    }
+    flush();
+    return delta;
+}
+
+/// Pass the target encoded by the delta to the sink as consecutive pieces
+/// pointing into the base or the delta, without building the target. The
+/// sink returns false to stop.
+///
+/// Returns an error if the delta is invalid or was made against a
+/// different base, otherwise false if the sink stopped.
+template <class Sink>
+auto apply_delta(std::string_view base, std::string_view delta, Sink&& sink)
+    -> tl::expected<bool, std::string>
+{
+    auto invalid = []
+    { return tl::make_unexpected(std::string{"not a valid delta"}); };
+
+    binary_reader reader(delta);
+    std::string_view magic;
+    std::uint64_t base_size = 0;
+    std::uint64_t base_hash = 0;
+    std::uint64_t target_size = 0;
+    if (!reader.read_bytes(4, magic) || magic != "DRD1" ||
+        !reader.read_varint(base_size) || !reader.read(base_hash) ||
+        !reader.read_varint(target_size))
+    {
+        return invalid();
+    }
+    if (base_size != base.size() || base_hash != fnv1a_64(base))
+    {
+        return tl::make_unexpected(
+            std::string{"the delta was made against a different base"});
+    }
+
+    std::uint64_t size = 0;
+    while (reader.remaining() > 0)
+    {
+        std::uint8_t op = 0;
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+        std::string_view piece;
+        reader.read(op);
+        if (op == static_cast<std::uint8_t>(delta_op::copy))
+        {
+            if (!reader.read_varint(offset) || !reader.read_varint(length) ||
+                offset > base.size() || length > base.size() - offset)
+            {
+                return invalid();
+            }
+            piece = base.substr(offset, length);
+        }
+        else if (op == static_cast<std::uint8_t>(delta_op::insert))
+        {
+            if (!reader.read_varint(length) ||
+                !reader.read_bytes(length, piece))
+            {
+                return invalid();
+            }
+        }
+        else
+        {
+            return invalid();
+        }
+
+        size += piece.size();
+        if (size > target_size)
+        {
+            return invalid();
+        }
+        if (!sink(piece))
+        {
+            return false;
+        }
+    }
+
+    if (size != target_size)
+    {
+        return invalid();
+    }
+    return true;
+}
+
+/// Return the target encoded by the delta
+inline auto apply_delta(std::string_view base, std::string_view delta)
+    -> tl::expected<std::string, std::string>
+{
+    std::string target;
+    auto result = apply_delta(base, delta,
+                              [&target](std::string_view piece)
+                              {
+                                  target.append(piece.data(), piece.size());
+                                  return true;
+                              });
+    if (!result)
+    {
+        return tl::make_unexpected(result.error());
+    }
+    return target;
+}
+
+/// Compare the data with the target encoded by the delta piece by piece,
+/// without building the target. Returns a description of the first
+/// difference if they differ.
+inline auto compare_delta(std::string_view data, std::string_view base,
+                          std::string_view delta)
+    -> tl::expected<void, std::string>
+{
+    std::size_t position = 0;
+    auto result = apply_delta(
+        base, delta,
+        [&](std::string_view piece)
+        {
+            std::size_t length = std::min(piece.size(), data.size() - position);
+            if (std::memcmp(piece.data(), data.data() + position, length) != 0)
+            {
+                // Stop at the first differing byte
+                auto first = std::mismatch(piece.begin(),
+                                           piece.begin() + length,
+                                           data.begin() + position);
+                position += first.first - piece.begin();
+                return false;
+            }
+            position += length;
+            return length == piece.size();
+        });
+
+    if (!result)
+    {
+        return tl::make_unexpected(result.error());
+    }
+    if (*result && position == data.size())
+    {
+        return {};
+    }
+
+    std::size_t line =
+        std::count(data.begin(), data.begin() + position, '\n') + 1;
+    return tl::make_unexpected("data differs from the recorded variant at "
+                               "line " +
+                               std::to_string(line));
+}
+
+}
\ No newline at end of file
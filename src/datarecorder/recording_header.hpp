@@ -0,0 +1,204 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "binary_format.hpp"
+#include "hash.hpp"
+
+namespace datarecorder
+{
+
+/// The format of the payload of a recording
+enum class recording_format : std::uint32_t
+{
+    /// Text or other data recorded with record()
+    raw = 0,
+
+    /// An array, see encode_array()
+    array = 1,
+
+    /// A table, see encode_table()
+    table = 2,
+
+    /// An event log, see event_log
+    event_log = 3,
+
+    /// A delta of a recording family, see encode_delta()
+    delta = 4
+};
+
+/// The header version written by this library. Readers reject newer
+/// versions, so a version bump is needed for any change old readers would
+/// misinterpret.
+constexpr std::uint16_t recording_header_version = 1;
+
+/// The size of the version 1 header. The header is "DRH1" followed by the
+/// version as u16, the header size as u16, the format as u32, the flags as
+/// u32, the payload size as u64 and the FNV-1a hash of the payload as u64,
+/// all little-endian. The magic stays the same in all versions.
+constexpr std::size_t recording_header_size = 32;
+
+/// The self-describing header of a recording
+struct recording_header
+{
+    /// The version of the header
+    std::uint16_t version = recording_header_version;
+
+    /// The format of the payload
+    recording_format format = recording_format::raw;
+
+    /// Flags describing the encoding of the payload, none are defined in
+    /// version 1
+    std::uint32_t flags = 0;
+
+    /// The size of the payload in bytes
+    std::uint64_t payload_size = 0;
+
+    /// The FNV-1a hash of the payload
+    std::uint64_t payload_hash = 0;
+};
+
+/// Return the format of the payload, recognized by its magic
+inline auto detect_format(std::string_view payload) -> recording_format
+{
+    std::string_view magic = payload.substr(0, 4);
+    if (magic == "DRA1")
+    {
+        return recording_format::array;
+    }
+    if (magic == "DRT1")
+    {
+        return recording_format::table;
+    }
+    if (magic == "DRE1")
+    {
+        return recording_format::event_log;
+    }
+    if (magic == "DRD1")
+    {
+        return recording_format::delta;
+    }
+    return recording_format::raw;
+}
+
+/// Return the header describing the payload
+inline auto make_recording_header(std::string_view payload)
+    -> recording_header
+{
+    recording_header header;
+    header.format = detect_format(payload);
+    header.payload_size = payload.size();
+    header.payload_hash = fnv1a_64(payload);
+    return header;
+}
+
+/// Append the header to the output
+template <class String>
+void append_recording_header(String& output, const recording_header& header)
+{
+    std::string encoded = "DRH1";
+    append_le(encoded, header.version);
+    append_le(encoded, static_cast<std::uint16_t>(recording_header_size));
+    append_le(encoded, static_cast<std::uint32_t>(header.format));
+    append_le(encoded, header.flags);
+    append_le(encoded, header.payload_size);
+    append_le(encoded, header.payload_hash);
+    output.append(encoded.data(), encoded.size());
+}
+
+/// Return true if the data starts with a recording header
+inline auto has_recording_header(std::string_view data) -> bool
+{
+    return data.substr(0, 4) == "DRH1";
+}
+
+/// Decode the header at the start of the data. Only the header itself is
+/// read, so the data may be just the beginning of a recording.
+inline auto decode_recording_header(std::string_view data)
+    -> tl::expected<recording_header, std::string>
+{
+    if (!has_recording_header(data))
+    {
+        return tl::make_unexpected(std::string("not a recording header"));
+    }
+    if (data.size() < 8)
+    {
+        return tl::make_unexpected(std::string("truncated recording header"));
+    }
+
+    recording_header header;
+    header.version = read_le<std::uint16_t>(data, 4);
+    auto header_size = read_le<std::uint16_t>(data, 6);
+    if (header.version > recording_header_version)
+    {
+        return tl::make_unexpected(
+            "recording header version " + std::to_string(header.version) +
+            " is newer than the supported version " +
+            std::to_string(recording_header_version));
+    }
+    if (header_size != recording_header_size || data.size() < header_size)
+    {
+        return tl::make_unexpected(std::string("truncated recording header"));
+    }
+
+    header.format =
+        static_cast<recording_format>(read_le<std::uint32_t>(data, 8));
+    header.flags = read_le<std::uint32_t>(data, 12);
+    header.payload_size = read_le<std::uint64_t>(data, 16);
+    header.payload_hash = read_le<std::uint64_t>(data, 24);
+    if (header.format > recording_format::delta)
+    {
+        return tl::make_unexpected(
+            "unknown recording format " +
+            std::to_string(static_cast<std::uint32_t>(header.format)));
+    }
+    if (header.flags != 0)
+    {
+        return tl::make_unexpected("unknown recording flags " +
+                                   std::to_string(header.flags));
+    }
+    return header;
+}
+
+/// Verify the header of the data against the payload following it and
+/// return the payload. Data without a header is returned as it is.
+inline auto verify_recording_header(std::string_view data)
+    -> tl::expected<std::string_view, std::string>
+{
+    if (!has_recording_header(data))
+    {
+        return data;
+    }
+
+    auto header = decode_recording_header(data);
+    if (!header)
+    {
+        return tl::make_unexpected(header.error());
+    }
+
+    std::string_view payload = data.substr(recording_header_size);
+    if (payload.size() != header->payload_size)
+    {
+        return tl::make_unexpected(
+            "the header announces " + std::to_string(header->payload_size) +
+            " bytes but the payload has " + std::to_string(payload.size()));
+    }
+    if (fnv1a_64(payload) != header->payload_hash)
+    {
+        return tl::make_unexpected(
+            std::string("the payload does not match the hash in the header"));
+    }
+    return payload;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace datarecorder
+{
+
+/// A monotonic arena for the buffers of the recorders on the current thread
+/// while it is alive, such as the recording read from disk or the joined
+/// lines of a vector. Allocations only bump a pointer and the memory is
+/// released all at once when the arena is destroyed, typically at the end
+/// of a test. Arenas can be nested, the innermost arena is used.
+///
+/// A recorder uses the memory resource set with set_memory_resource(), then
+/// the innermost arena and finally the default memory resource.
+///
+/// Example:
+///     TEST(codec, decode)
+///     {
+///         datarecorder::scoped_arena arena;
+///         recorder.record(decode(input));
+///     }
+///
+/// To avoid the global heap entirely, give the arena a buffer that is
+/// reused between tests:
+///
+///     static std::byte buffer[1 << 20];
+///     datarecorder::scoped_arena arena(buffer, sizeof(buffer));
+class scoped_arena
+{
+public:
+    /// Constructor. The first block of the given size is allocated from the
+    /// upstream resource when it is first needed, larger blocks follow.
+    explicit scoped_arena(std::size_t initial_size = 64 * 1024,
+                          std::pmr::memory_resource* upstream =
+                              std::pmr::get_default_resource()) :
+        m_resource(initial_size, upstream), m_previous(slot())
+    {
+        slot() = &m_resource;
+    }
+
+    /// Constructor using the buffer first. Only if the buffer is exhausted
+    /// are blocks allocated from the upstream resource.
+    scoped_arena(void* buffer, std::size_t size,
+                 std::pmr::memory_resource* upstream =
+                     std::pmr::get_default_resource()) :
+        m_resource(buffer, size, upstream), m_previous(slot())
+    {
+        slot() = &m_resource;
+    }
+
+    /// Destructor releases all memory of the arena
+    ~scoped_arena()
+    {
+        slot() = m_previous;
+    }
+
+    scoped_arena(const scoped_arena&) = delete;
+    scoped_arena& operator=(const scoped_arena&) = delete;
+
+    /// The memory resource of the arena
+    auto resource() -> std::pmr::memory_resource*
+    {
+        return &m_resource;
+    }
+
+    /// The memory resource of the innermost arena on the current thread, or
+    /// nullptr if there is none
+    static auto current() -> std::pmr::memory_resource*
+    {
+        return slot();
+    }
+
+private:
+    static auto slot() -> std::pmr::memory_resource*&
+    {
+        thread_local std::pmr::memory_resource* resource = nullptr;
+        return resource;
+    }
+
+private:
+    std::pmr::monotonic_buffer_resource m_resource;
+    std::pmr::memory_resource* m_previous;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,357 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "diff.hpp"
+#include "hunk_viewer.hpp"
+#include "json_string.hpp"
+#include "mismatch_info.hpp"
+#include "mismatch_registry.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// The page written as index.html in the session directory. The mismatches
+/// are loaded from the data bundle and the hunks of a mismatch are only
+/// loaded from its hunk file and rendered when it is expanded.
+inline auto session_index_html() -> std::string
+{
+    return std::string(R"html(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>datarecorder mismatches</title>
+<style>
+body { font-family: sans-serif; margin: 1em; }
+details { border: 1px solid #ccc; margin: 0.5em 0; padding: 0.3em; }
+summary { cursor: pointer; }
+pre { margin: 0; font-family: monospace; white-space: pre; }
+.hunk { margin: 0.5em 0; border-top: 1px dashed #ccc; }
+.del { background: #fdd; }
+.add { background: #dfd; }
+.info { color: #666; }
+</style>
+</head>
+<body>
+<h1>datarecorder mismatches</h1>
+<p id="summary" class="info">Loading...</p>
+<div id="mismatches"></div>
+<script>
+)html") + hunk_header_js() + R"html(function render_hunks(container, hunks) {
+    hunks.forEach(function(hunk) {
+        var div = document.createElement("div");
+        div.className = "hunk";
+        var header = document.createElement("pre");
+        header.className = "info";
+        header.textContent = hunk_header(hunk);
+        div.appendChild(header);
+        for (var i = 0; i < hunk.lines.length; ++i) {
+            var op = hunk.ops[i];
+            var line = document.createElement("pre");
+            line.className = op == "-" ? "del" : op == "+" ? "add" : "";
+            line.textContent = op + " " + hunk.lines[i];
+            div.appendChild(line);
+        }
+        container.appendChild(div);
+    });
+}
+function load() {
+    var mismatches = window.datarecorder_mismatches || [];
+    document.getElementById("summary").textContent =
+        mismatches.length + " mismatch(es)";
+    var list = document.getElementById("mismatches");
+    mismatches.forEach(function(mismatch) {
+        var details = document.createElement("details");
+        var summary = document.createElement("summary");
+        summary.textContent = mismatch.name + " (" + mismatch.hunk_count +
+            " hunk(s), recording " + mismatch.recording_size +
+            " bytes, produced " + mismatch.mismatch_size + " bytes)" +
+            (mismatch.duplicates.length ?
+                " also seen " + mismatch.duplicates.length + " time(s)" : "");
+        details.appendChild(summary);
+        var info = document.createElement("pre");
+        info.className = "info";
+        info.textContent = "recording: " + mismatch.recording_path +
+            "\nproduced:  " + mismatch.mismatch_path +
+            (mismatch.description ? "\n" + mismatch.description : "") +
+            mismatch.duplicates.map(function(path) {
+                return "\nalso in:   " + path; }).join("");
+        details.appendChild(info);
+        var loaded = false;
+        details.addEventListener("toggle", function() {
+            if (details.open && !loaded) {
+                loaded = true;
+                var script = document.createElement("script");
+                script.src = mismatch.hunks_file;
+                script.onload = function() {
+                    render_hunks(details,
+                        window.datarecorder_session_hunks[mismatch.hunks_file]);
+                };
+                document.body.appendChild(script);
+            }
+        });
+        list.appendChild(details);
+    });
+}
+</script>
+<script src="mismatches.js" defer onload="load()"></script>
+</body>
+</html>
+)html";
+}
+
+/// Collects the mismatches of a test session and writes a single index page
+/// and data bundle, instead of a separate set of artifacts per mismatch.
+///
+/// When a mismatch is added its produced data and diff hunks are written to
+/// files in the session directory right away, so only a short summary of
+/// each mismatch is kept in memory. The index page and the data bundle of
+/// the summaries are written by flush(), which the process-wide instance()
+/// calls at exit.
+///
+/// Several processes, like the shards of a test binary, can share a session
+/// directory. The produced data is written to files prefixed with the
+/// process_token() and every flush() appends the new mismatches to the data
+/// bundle with a single write, so the index page shows the mismatches of
+/// all processes.
+///
+/// Example:
+///     datarecorder::datarecorder recorder;
+///     recorder.use_session();
+///
+/// Alternatively set the DATARECORDER_SESSION environment variable to use the
+/// session for all recorders that have no mismatch handler set, or set the
+/// DATARECORDER_SESSION_DIR environment variable to the directory shared by
+/// the processes of a test run.
+class session
+{
+public:
+    /// The process-wide session written when the process exits, to the
+    /// directory in the DATARECORDER_SESSION_DIR environment variable or
+    /// else the next free /tmp/cppmismatch-N directory.
+    static auto instance() -> session&
+    {
+        static session instance(
+            []
+            {
+                const char* dir = std::getenv("DATARECORDER_SESSION_DIR");
+                return dir != nullptr && *dir != '\0'
+                           ? std::filesystem::path(dir)
+                           : next_mismatch_dir();
+            }());
+        return instance;
+    }
+
+    /// Constructor
+    explicit session(std::filesystem::path session_dir) :
+        m_session_dir(std::move(session_dir))
+    {
+    }
+
+    /// Destructor writes the index page and the data bundle
+    ~session()
+    {
+        flush();
+    }
+
+    session(const session&) = delete;
+    session& operator=(const session&) = delete;
+
+    /// Add a mismatch to the session. The produced data and the hunks are
+    /// written to the session directory right away and the path of the
+    /// produced data is returned. The hunks are written next to it with the
+    /// ".hunks.js" extension appended.
+    ///
+    /// Mismatches are deduplicated by their fingerprint, a repeated
+    /// mismatch is only counted and the path of the first one is returned.
+    auto add(const mismatch_info& mismatch) -> std::filesystem::path
+    {
+        std::uint64_t fingerprint = mismatch_fingerprint(mismatch);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_fingerprints.find(fingerprint);
+            if (it != m_fingerprints.end())
+            {
+                entry& e = m_entries[it->second];
+                e.duplicates.push_back(mismatch.recording_path);
+                return e.mismatch_path;
+            }
+        }
+
+        entry e;
+        e.name = mismatch.recording_path.filename().string();
+        e.recording_path = mismatch.recording_path;
+        e.description = mismatch.description;
+        e.recording_size = mismatch.recording_data.size();
+        e.mismatch_size = mismatch.mismatch_data.size();
+        auto hunks =
+            diff_lines(mismatch.recording_data, mismatch.mismatch_data);
+        e.hunk_count = hunks.size();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // Another thread may have added the same mismatch while the hunks
+        // were computed
+        auto it = m_fingerprints.find(fingerprint);
+        if (it != m_fingerprints.end())
+        {
+            entry& first = m_entries[it->second];
+            first.duplicates.push_back(mismatch.recording_path);
+            return first.mismatch_path;
+        }
+
+        // The file is created exclusively, in the unlikely case that two
+        // processes share the token the next number is tried
+        do
+        {
+            e.mismatch_path =
+                m_session_dir / (std::to_string(process_token()) + "-" +
+                                 std::to_string(m_next_file++) + "-" + e.name);
+        } while (!create_file_exclusive(e.mismatch_path,
+                                        mismatch.mismatch_data));
+
+        std::filesystem::path mismatch_path = e.mismatch_path;
+        m_fingerprints[fingerprint] = m_entries.size();
+        m_entries.push_back(std::move(e));
+        lock.unlock();
+
+        // The name of the produced data file is unique, so the hunk file
+        // can be written without the lock
+        std::string key = mismatch_path.filename().string() + ".hunks.js";
+        std::string content = "window.datarecorder_session_hunks = "
+                              "window.datarecorder_session_hunks || {};\n"
+                              "window.datarecorder_session_hunks[";
+        append_json_string(content, key);
+        content += "] = ";
+        append_hunks_json(content, hunks);
+        content += ";\n";
+        write_file_atomic(m_session_dir / key, content);
+
+        return mismatch_path;
+    }
+
+    /// @return True if a mismatch with the fingerprint was added
+    auto contains(std::uint64_t fingerprint) const -> bool
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_fingerprints.count(fingerprint) != 0;
+    }
+
+    /// Append the mismatches added since the last flush to the data bundle
+    /// and write the index page. Does nothing if no mismatches were added.
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_flushed == m_entries.size())
+        {
+            return;
+        }
+
+        std::string bundle =
+            "window.datarecorder_mismatches = "
+            "(window.datarecorder_mismatches || []).concat([\n";
+        for (std::size_t i = m_flushed; i < m_entries.size(); ++i)
+        {
+            const entry& e = m_entries[i];
+            bundle += "{\"name\": ";
+            append_json_string(bundle, e.name);
+            bundle += ", \"recording_path\": ";
+            append_json_string(bundle, e.recording_path.string());
+            bundle += ", \"mismatch_path\": ";
+            append_json_string(bundle, e.mismatch_path.string());
+            bundle += ", \"description\": ";
+            append_json_string(bundle, e.description);
+            bundle += ", \"duplicates\": [";
+            for (std::size_t i = 0; i < e.duplicates.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    bundle += ", ";
+                }
+                append_json_string(bundle, e.duplicates[i].string());
+            }
+            bundle += "]";
+            bundle += ", \"recording_size\": " +
+                      std::to_string(e.recording_size) +
+                      ", \"mismatch_size\": " +
+                      std::to_string(e.mismatch_size) +
+                      ", \"hunk_count\": " + std::to_string(e.hunk_count) +
+                      ", \"hunks_file\": ";
+            append_json_string(bundle,
+                               e.mismatch_path.filename().string() +
+                                   ".hunks.js");
+            bundle += "},\n";
+        }
+        bundle += "]);\n";
+
+        append_file(m_session_dir / "mismatches.js", bundle);
+        write_file_atomic(index_path(), session_index_html());
+        m_flushed = m_entries.size();
+    }
+
+    /// The directory where the session is written
+    auto session_dir() const -> const std::filesystem::path&
+    {
+        return m_session_dir;
+    }
+
+    /// The path of the index page
+    auto index_path() const -> std::filesystem::path
+    {
+        return m_session_dir / "index.html";
+    }
+
+    /// The number of distinct mismatches added to the session
+    auto size() const -> std::size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+private:
+    struct entry
+    {
+        std::string name;
+        std::filesystem::path recording_path;
+        std::filesystem::path mismatch_path;
+        std::string description;
+        std::size_t recording_size = 0;
+        std::size_t mismatch_size = 0;
+        std::size_t hunk_count = 0;
+
+        /// Recordings that had the identical mismatch
+        std::vector<std::filesystem::path> duplicates;
+    };
+
+private:
+    std::filesystem::path m_session_dir;
+
+    mutable std::mutex m_mutex;
+    std::vector<entry> m_entries;
+
+    /// Index of the entry for each mismatch fingerprint
+    std::unordered_map<std::uint64_t, std::size_t> m_fingerprints;
+
+    /// The number of entries written to the data bundle
+    std::size_t m_flushed = 0;
+
+    /// The number of the next produced data file
+    std::size_t m_next_file = 0;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <verify/verify.hpp>
+
+namespace datarecorder
+{
+
+/// Open the file at path for writing, creating the parent directories if
+/// they don't exist.
+inline auto open_output_file(const std::filesystem::path& path,
+                             std::ios::openmode mode = {}) -> std::ofstream
+{
+    // Create parent directories if they don't exist
+    std::filesystem::path parent_dir = path.parent_path();
+    if (!parent_dir.empty() && !std::filesystem::exists(parent_dir))
+    {
+        std::error_code ec;
+        bool created = std::filesystem::create_directories(parent_dir, ec);
+        VERIFY(created || std::filesystem::exists(parent_dir),
+               "Could not create parent directories", ec, parent_dir);
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc | mode);
+    VERIFY(file.is_open(), "Could not open file for writing", errno, path);
+
+    return file;
+}
+
+/// Write data to the file at path, creating the parent directories if they
+/// don't exist.
+inline void write_file(const std::filesystem::path& path,
+                       std::string_view data)
+{
+    std::ofstream file = open_output_file(path);
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    VERIFY(file.good(), "Could not write to file", errno);
+}
+
+/// Read all data from the file at path
+inline auto read_file(const std::filesystem::path& path) -> std::string
+{
+    std::ifstream file(path, std::ios::in);
+    VERIFY(file.is_open(), "Could not open file for reading", errno);
+
+    // Read all data from the file
+    std::string data{std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>()};
+
+    file.close();
+
+    return data;
+}
+
+/// Read all data from the file at path into a string allocated from the
+/// memory resource
+inline auto read_file(const std::filesystem::path& path,
+                      std::pmr::memory_resource* resource) -> std::pmr::string
+{
+    std::ifstream file(path, std::ios::in);
+    VERIFY(file.is_open(), "Could not open file for reading", errno);
+
+    std::pmr::string data(resource);
+    data.reserve(std::filesystem::file_size(path));
+    data.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+
+    return data;
+}
+
+/// Write binary data to the file at path, creating the parent directories if
+/// they don't exist.
+inline void write_binary_file(const std::filesystem::path& path,
+                              std::string_view data)
+{
+    std::ofstream file = open_output_file(path, std::ios::binary);
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    VERIFY(file.good(), "Could not write to file", errno);
+}
+
+/// Read all binary data from the file at path
+inline auto read_binary_file(const std::filesystem::path& path) -> std::string
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    VERIFY(file.is_open(), "Could not open file for reading", errno);
+
+    std::string data(std::filesystem::file_size(path), '\0');
+    file.read(&data[0], data.size());
+    VERIFY(file.good(), "Could not read from file", errno);
+
+    return data;
+}
+
+/// Read all binary data from the file at path into a string allocated from
+/// the memory resource
+inline auto read_binary_file(const std::filesystem::path& path,
+                             std::pmr::memory_resource* resource)
+    -> std::pmr::string
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    VERIFY(file.is_open(), "Could not open file for reading", errno);
+
+    std::pmr::string data(std::filesystem::file_size(path), '\0', resource);
+    file.read(&data[0], data.size());
+    VERIFY(file.good(), "Could not read from file", errno);
+
+    return data;
+}
+
+/// Read up to size bytes from the beginning of the file at path into the
+/// buffer and return the number of bytes read
+inline auto read_file_prefix(const std::filesystem::path& path, char* buffer,
+                             std::size_t size) -> std::size_t
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    VERIFY(file.is_open(), "Could not open file for reading", errno);
+
+    file.read(buffer, size);
+    return static_cast<std::size_t>(file.gcount());
+}
+
+/// Return a number identifying the process among processes sharing files.
+/// It is drawn at random once per process.
+inline auto process_token() -> std::uint32_t
+{
+    static const std::uint32_t token = std::random_device{}();
+    return token;
+}
+
+/// Return a unique path for a temporary file next to the file at path
+inline auto temporary_path(const std::filesystem::path& path)
+    -> std::filesystem::path
+{
+    static std::atomic<std::uint64_t> counter{0};
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp-" + std::to_string(process_token()) + "-" +
+                 std::to_string(counter++);
+    return temporary;
+}
+
+/// Write data to a temporary file next to the file at path and return the
+/// path of the temporary file
+inline auto write_temporary_file(const std::filesystem::path& path,
+                                 std::string_view data,
+                                 std::ios::openmode mode = {})
+    -> std::filesystem::path
+{
+    std::filesystem::path temporary = temporary_path(path);
+    std::ofstream file = open_output_file(temporary, mode);
+    file.write(data.data(), data.size());
+    file.close();
+    VERIFY(file.good(), "Could not write to file", errno, temporary);
+    return temporary;
+}
+
+/// Write data to the file at path by writing a temporary file and renaming
+/// it, so other processes see either the old or the new file but never a
+/// partially written one.
+inline void write_file_atomic(const std::filesystem::path& path,
+                              std::string_view data,
+                              std::ios::openmode mode = {})
+{
+    std::filesystem::path temporary = write_temporary_file(path, data, mode);
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary);
+    }
+    VERIFY(!ec, "Could not rename file", ec, path);
+}
+
+/// Create the file at path with the data unless it exists. The data is
+/// written to a temporary file that is then hard linked to the path, which
+/// fails if the path exists, so of several processes creating the same file
+/// exactly one succeeds and the others never see a partially written file.
+///
+/// Returns false if the file already existed, it is left untouched.
+inline auto create_file_exclusive(const std::filesystem::path& path,
+                                  std::string_view data,
+                                  std::ios::openmode mode = {}) -> bool
+{
+    std::filesystem::path temporary = write_temporary_file(path, data, mode);
+
+    std::error_code ec;
+    std::filesystem::create_hard_link(temporary, path, ec);
+    if (ec && !std::filesystem::exists(path))
+    {
+        // The file system has no hard links, fall back to a rename which
+        // is still atomic but may replace a file created concurrently
+        std::filesystem::rename(temporary, path, ec);
+        VERIFY(!ec, "Could not create file", ec, path);
+        return true;
+    }
+
+    std::filesystem::remove(temporary);
+    return !ec;
+}
+
+/// Append data to the file at path with a single unbuffered write, creating
+/// the file and its parent directories if they don't exist. Appends of
+/// several processes to a regular file are not interleaved.
+inline void append_file(const std::filesystem::path& path,
+                        std::string_view data)
+{
+    std::filesystem::path parent_dir = path.parent_path();
+    if (!parent_dir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(parent_dir, ec);
+    }
+
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(path, std::ios::binary | std::ios::app);
+    VERIFY(file.is_open(), "Could not open file for appending", errno, path);
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    VERIFY(file.good(), "Could not write to file", errno);
+}
+
+/// Return the next free mismatch directory i.e. /tmp/cppmismatch-N where N is
+/// a consecutive number incremented if the directory already exists. The
+/// directory is not created.
+inline auto next_mismatch_dir() -> std::filesystem::path
+{
+    std::filesystem::path tmp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path mismatch_dir = tmp_dir / "cppmismatch-0";
+
+    std::size_t i = 0;
+    while (std::filesystem::exists(mismatch_dir))
+    {
+        ++i;
+        mismatch_dir = tmp_dir / ("cppmismatch-" + std::to_string(i));
+    }
+
+    return mismatch_dir;
+}
+
+/// Create the mismatch directory and return it. If the directory already
+/// exists, because another process created it after it was chosen, the
+/// next free mismatch directory is created instead. Creating a directory is
+/// atomic, so concurrent processes never write to the same mismatch
+/// directory.
+inline auto create_mismatch_dir(
+    std::filesystem::path mismatch_dir = next_mismatch_dir())
+    -> std::filesystem::path
+{
+    while (true)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(mismatch_dir.parent_path(), ec);
+        if (std::filesystem::create_directory(mismatch_dir, ec))
+        {
+            return mismatch_dir;
+        }
+        VERIFY(!ec, "Could not create mismatch directory", ec, mismatch_dir);
+        mismatch_dir = next_mismatch_dir();
+    }
+}
+
+}
\ No newline at end of file
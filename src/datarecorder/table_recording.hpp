@@ -0,0 +1,594 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <tl/expected.hpp>
+#include <verify/verify.hpp>
+
+#include "array_recording.hpp"
+#include "binary_format.hpp"
+#include "comparator.hpp"
+#include "numeric_comparator.hpp"
+
+namespace datarecorder
+{
+
+/// The type of a table column
+enum class column_type : std::uint8_t
+{
+    /// 64 bit signed integers
+    integer = 1,
+
+    /// 64 bit floating point numbers
+    floating_point = 2,
+
+    /// Strings compared exactly
+    text = 3
+};
+
+/// Return the name of the column type
+inline auto column_type_name(column_type type) -> std::string
+{
+    switch (type)
+    {
+    case column_type::integer:
+        return "integer";
+    case column_type::floating_point:
+        return "floating_point";
+    case column_type::text:
+        return "text";
+    default:
+        return "unknown";
+    }
+}
+
+/// A column of a table schema
+struct table_column
+{
+    /// The name of the column
+    std::string name;
+
+    /// The type of the column
+    column_type type;
+
+    /// The tolerance used when comparing numbers in the column
+    struct tolerance tolerance;
+};
+
+/// The columns of a table
+///
+/// Example:
+///     datarecorder::tolerance rate_tolerance;
+///     rate_tolerance.relative = 1e-9;
+///
+///     datarecorder::table_schema schema;
+///     schema.add_column("flow", datarecorder::column_type::integer)
+///         .add_column("protocol", datarecorder::column_type::text)
+///         .add_column("rate", datarecorder::column_type::floating_point,
+///                     rate_tolerance);
+class table_schema
+{
+public:
+    /// Add a column
+    auto add_column(std::string name, column_type type,
+                    tolerance tolerance = {}) -> table_schema&
+    {
+        VERIFY(!name.empty(), "Column name must not be empty");
+        VERIFY(name.size() <= 0xffff, "Column name too long", name);
+        VERIFY(!find(name), "Duplicate column name", name);
+
+        m_columns.push_back({std::move(name), type, tolerance});
+        return *this;
+    }
+
+    /// Return the index of the column with the name if it exists
+    auto find(std::string_view name) const -> std::optional<std::size_t>
+    {
+        for (std::size_t i = 0; i < m_columns.size(); ++i)
+        {
+            if (m_columns[i].name == name)
+            {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// The columns
+    auto columns() const -> const std::vector<table_column>&
+    {
+        return m_columns;
+    }
+
+private:
+    std::vector<table_column> m_columns;
+};
+
+/// A table of values following a schema. The values are kept column by
+/// column, which is also how they are recorded.
+///
+/// Example:
+///     datarecorder::table table(schema);
+///     table.add_row(1, "tcp", 12.5);
+///     table.add_row(2, "udp", 3.25);
+///     recorder.record_table(table);
+class table
+{
+public:
+    /// Constructor
+    explicit table(table_schema schema) :
+        m_schema(std::move(schema)), m_columns(m_schema.columns().size())
+    {
+    }
+
+    /// Add a row with a value for every column. Integer columns take
+    /// integers, floating point columns numbers and text columns strings.
+    template <class... Values>
+    void add_row(const Values&... values)
+    {
+        VERIFY(sizeof...(Values) == m_columns.size(),
+               "Row must have a value for every column", sizeof...(Values),
+               m_columns.size());
+
+        std::size_t column = 0;
+        (add_value(column++, values), ...);
+        ++m_rows;
+    }
+
+    /// The schema
+    auto schema() const -> const table_schema&
+    {
+        return m_schema;
+    }
+
+    /// The number of rows
+    auto rows() const -> std::size_t
+    {
+        return m_rows;
+    }
+
+    /// The values of an integer column
+    auto integers(std::size_t column) const -> const std::vector<std::int64_t>&
+    {
+        VERIFY(type(column) == column_type::integer, "Not an integer column");
+        return m_columns[column].integers;
+    }
+
+    /// The values of a floating point column
+    auto floats(std::size_t column) const -> const std::vector<double>&
+    {
+        VERIFY(type(column) == column_type::floating_point,
+               "Not a floating point column");
+        return m_columns[column].floats;
+    }
+
+    /// The values of a text column
+    auto texts(std::size_t column) const -> const std::vector<std::string>&
+    {
+        VERIFY(type(column) == column_type::text, "Not a text column");
+        return m_columns[column].texts;
+    }
+
+private:
+    auto type(std::size_t column) const -> column_type
+    {
+        VERIFY(column < m_columns.size(), "Column out of range", column);
+        return m_schema.columns()[column].type;
+    }
+
+    template <class Value>
+    void add_value(std::size_t column, const Value& value)
+    {
+        if constexpr (std::is_integral<Value>::value)
+        {
+            if (type(column) == column_type::floating_point)
+            {
+                m_columns[column].floats.push_back(static_cast<double>(value));
+                return;
+            }
+            VERIFY(type(column) == column_type::integer,
+                   "Integer value in a non-numeric column",
+                   m_schema.columns()[column].name);
+            m_columns[column].integers.push_back(
+                static_cast<std::int64_t>(value));
+        }
+        else if constexpr (std::is_floating_point<Value>::value)
+        {
+            VERIFY(type(column) == column_type::floating_point,
+                   "Floating point value in a non floating point column",
+                   m_schema.columns()[column].name);
+            m_columns[column].floats.push_back(static_cast<double>(value));
+        }
+        else
+        {
+            VERIFY(type(column) == column_type::text,
+                   "Text value in a non-text column",
+                   m_schema.columns()[column].name);
+            m_columns[column].texts.emplace_back(value);
+        }
+    }
+
+private:
+    struct column_data
+    {
+        std::vector<std::int64_t> integers;
+        std::vector<double> floats;
+        std::vector<std::string> texts;
+    };
+
+    table_schema m_schema;
+    std::vector<column_data> m_columns;
+    std::size_t m_rows = 0;
+};
+
+/// Encode the table as a table recording. Everything is stored
+/// little-endian, first the header and the column descriptions:
+///
+///     "DRT1", u32 column count, u64 row count
+///     per column: u8 column_type, u16 name length, name
+///
+/// followed by the values of each column. Numbers are stored as a column
+/// of 8 byte values, text as a column of u64 end offsets followed by the
+/// concatenated strings.
+inline auto encode_table(const table& table) -> std::string
+{
+    const auto& columns = table.schema().columns();
+
+    std::string output;
+    output.append("DRT1", 4);
+    append_le(output, static_cast<std::uint32_t>(columns.size()));
+    append_le(output, static_cast<std::uint64_t>(table.rows()));
+    for (const auto& column : columns)
+    {
+        append_le(output, static_cast<std::uint8_t>(column.type));
+        append_le(output, static_cast<std::uint16_t>(column.name.size()));
+        output += column.name;
+    }
+
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+        switch (columns[i].type)
+        {
+        case column_type::integer:
+            append_le(output, table.integers(i).data(), table.rows());
+            break;
+        case column_type::floating_point:
+            append_le(output, table.floats(i).data(), table.rows());
+            break;
+        case column_type::text:
+        {
+            std::uint64_t end = 0;
+            for (const auto& text : table.texts(i))
+            {
+                end += text.size();
+                append_le(output, end);
+            }
+            for (const auto& text : table.texts(i))
+            {
+                output += text;
+            }
+            break;
+        }
+        }
+    }
+    return output;
+}
+
+/// A decoded column of a table recording, the values point into the
+/// recording
+struct column_view
+{
+    std::string_view name;
+    column_type type;
+
+    /// The 8 byte numbers, or the end offsets of the strings
+    std::string_view values;
+
+    /// The concatenated strings of a text column
+    std::string_view text;
+
+    /// Return the text in the row of a text column
+    auto text_at(std::size_t row) const -> std::string_view
+    {
+        std::uint64_t begin =
+            row == 0 ? 0 : read_le<std::uint64_t>(values, (row - 1) * 8);
+        std::uint64_t end = read_le<std::uint64_t>(values, row * 8);
+        return text.substr(begin, end - begin);
+    }
+};
+
+/// A decoded table recording
+struct table_view
+{
+    std::uint64_t rows = 0;
+    std::vector<column_view> columns;
+};
+
+/// Decode a table recording without copying the values
+inline auto decode_table(std::string_view data)
+    -> tl::expected<table_view, std::string>
+{
+    auto invalid = []
+    { return tl::make_unexpected(std::string{"not a valid table recording"}); };
+
+    binary_reader reader(data);
+    std::string_view magic;
+    std::uint32_t column_count = 0;
+    table_view view;
+    if (!reader.read_bytes(4, magic) || magic != "DRT1" ||
+        !reader.read(column_count) || !reader.read(view.rows))
+    {
+        return invalid();
+    }
+
+    for (std::uint32_t i = 0; i < column_count; ++i)
+    {
+        std::uint8_t type = 0;
+        std::uint16_t name_size = 0;
+        column_view column;
+        if (!reader.read(type) || !reader.read(name_size) ||
+            !reader.read_bytes(name_size, column.name) ||
+            type < static_cast<std::uint8_t>(column_type::integer) ||
+            type > static_cast<std::uint8_t>(column_type::text))
+        {
+            return invalid();
+        }
+        column.type = static_cast<column_type>(type);
+        view.columns.push_back(column);
+    }
+
+    for (auto& column : view.columns)
+    {
+        if (view.rows > reader.remaining() / 8 ||
+            !reader.read_bytes(view.rows * 8, column.values))
+        {
+            return invalid();
+        }
+        if (column.type == column_type::text)
+        {
+            std::uint64_t size =
+                view.rows == 0
+                    ? 0
+                    : read_le<std::uint64_t>(column.values,
+                                             (view.rows - 1) * 8);
+            std::uint64_t previous = 0;
+            for (std::uint64_t row = 0; row < view.rows; ++row)
+            {
+                std::uint64_t end = read_le<std::uint64_t>(column.values,
+                                                           row * 8);
+                if (end < previous)
+                {
+                    return invalid();
+                }
+                previous = end;
+            }
+            if (size > reader.remaining() ||
+                !reader.read_bytes(size, column.text))
+            {
+                return invalid();
+            }
+        }
+    }
+
+    if (reader.remaining() != 0)
+    {
+        return invalid();
+    }
+    return view;
+}
+
+/// The differing cells of a column
+struct cell_difference
+{
+    /// The number of differing cells
+    std::size_t cells = 0;
+
+    /// The first differing row and its values
+    std::size_t row = 0;
+    std::string value;
+    std::string recorded_value;
+};
+
+/// Compare two columns of 8 byte numbers. Identical columns are detected
+/// with a single memcmp of their encoded values. Otherwise the columns are
+/// decoded to aligned arrays and every row that is not bitwise equal is
+/// checked with within_tolerance(), which compares integers exactly.
+template <class T>
+auto compare_numbers(std::string_view values, std::string_view recorded,
+                     const tolerance& tolerance) -> cell_difference
+{
+    if (values == recorded)
+    {
+        return {};
+    }
+
+    const std::size_t rows = values.size() / sizeof(T);
+    std::vector<T> a(rows);
+    std::vector<T> b(rows);
+    read_le(values, 0, a.data(), rows);
+    read_le(recorded, 0, b.data(), rows);
+
+    cell_difference difference;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        if (std::memcmp(&a[row], &b[row], sizeof(T)) == 0 ||
+            within_tolerance<T>(a[row], b[row], tolerance))
+        {
+            continue;
+        }
+        if (difference.cells++ == 0)
+        {
+            difference.row = row;
+            difference.value = to_string_exact(a[row]);
+            difference.recorded_value = to_string_exact(b[row]);
+        }
+    }
+    return difference;
+}
+
+/// Compare two text columns
+inline auto compare_texts(const column_view& column,
+                          const column_view& recorded, std::size_t rows)
+    -> cell_difference
+{
+    cell_difference difference;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        std::string_view a = column.text_at(row);
+        std::string_view b = recorded.text_at(row);
+        if (a == b)
+        {
+            continue;
+        }
+        if (difference.cells++ == 0)
+        {
+            difference.row = row;
+            difference.value = "\"" + std::string(a) + "\"";
+            difference.recorded_value = "\"" + std::string(b) + "\"";
+        }
+    }
+    return difference;
+}
+
+/// Return a comparator for table recordings with the schema. The columns
+/// are matched by name and compared column by column, numbers under the
+/// tolerance of their column and text exactly. Every differing column is
+/// reported with the (row, column) of its first differing cell and the
+/// number of differing cells.
+inline auto table_comparator(table_schema schema) -> comparator
+{
+    return [schema](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        auto produced = decode_table(data);
+        if (!produced)
+        {
+            return tl::make_unexpected("produced " + produced.error());
+        }
+        auto recorded = decode_table(recording);
+        if (!recorded)
+        {
+            return tl::make_unexpected(recorded.error());
+        }
+
+        std::string description;
+        auto report = [&description](const std::string& line)
+        {
+            if (!description.empty())
+            {
+                description += "\n";
+            }
+            description += line;
+        };
+
+        if (produced->rows != recorded->rows)
+        {
+            return tl::make_unexpected(
+                "table has " + std::to_string(produced->rows) +
+                " rows, the recording has " + std::to_string(recorded->rows));
+        }
+
+        for (const auto& column : recorded->columns)
+        {
+            bool found = false;
+            for (const auto& other : produced->columns)
+            {
+                found = found || other.name == column.name;
+            }
+            if (!found)
+            {
+                report("column \"" + std::string(column.name) +
+                       "\" is missing");
+            }
+        }
+
+        for (const auto& column : produced->columns)
+        {
+            const column_view* other = nullptr;
+            for (const auto& candidate : recorded->columns)
+            {
+                if (candidate.name == column.name)
+                {
+                    other = &candidate;
+                }
+            }
+
+            const std::string name = "\"" + std::string(column.name) + "\"";
+            if (other == nullptr)
+            {
+                report("column " + name + " is not in the recording");
+                continue;
+            }
+            if (other->type != column.type)
+            {
+                report("column " + name + " has type " +
+                       column_type_name(column.type) +
+                       ", the recording has " +
+                       column_type_name(other->type));
+                continue;
+            }
+
+            // Identical columns are skipped with a single memcmp
+            if (column.values == other->values && column.text == other->text)
+            {
+                continue;
+            }
+
+            tolerance tolerance;
+            if (auto index = schema.find(column.name))
+            {
+                tolerance = schema.columns()[*index].tolerance;
+            }
+
+            cell_difference difference;
+            switch (column.type)
+            {
+            case column_type::integer:
+                difference = compare_numbers<std::int64_t>(
+                    column.values, other->values, tolerance);
+                break;
+            case column_type::floating_point:
+                difference = compare_numbers<double>(column.values,
+                                                     other->values, tolerance);
+                break;
+            case column_type::text:
+                difference = compare_texts(column, *other, produced->rows);
+                break;
+            }
+
+            if (difference.cells > 0)
+            {
+                report("(row " + std::to_string(difference.row) +
+                       ", column " + name + ") is " + difference.value +
+                       ", the recording has " + difference.recorded_value +
+                       "; " + std::to_string(difference.cells) +
+                       " differing cell(s) in the column");
+            }
+        }
+
+        if (description.empty())
+        {
+            return {};
+        }
+        return tl::make_unexpected(description);
+    };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <tl/expected.hpp>
+
+#include "comparator.hpp"
+#include "hash.hpp"
+#include "json_string.hpp"
+
+namespace datarecorder
+{
+
+/// Call the function with every line of the data without its newline. A
+/// final newline does not start another line.
+template <class Function>
+void for_each_line(std::string_view data, Function&& function)
+{
+    std::size_t begin = 0;
+    while (begin < data.size())
+    {
+        const void* newline =
+            std::memchr(data.data() + begin, '\n', data.size() - begin);
+        std::size_t end = newline == nullptr
+                              ? data.size()
+                              : static_cast<const char*>(newline) - data.data();
+        function(data.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+/// Return a comparator that ignores the order of the lines. The data
+/// matches the recording if both have the same lines the same number of
+/// times, as is the case for the interleaved output of threads.
+///
+/// The lines are counted in a hash table in a single pass over both sides,
+/// so the comparison is linear and nothing is sorted. On a mismatch the
+/// description lists the surplus lines only found in the data and the lines
+/// missing from it, in the order they first appear, at most max_lines of
+/// each.
+///
+/// Example:
+///     recorder.set_comparator(datarecorder::unordered_lines_comparator());
+inline auto unordered_lines_comparator(std::size_t max_lines = 10)
+    -> comparator
+{
+    return [max_lines](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        struct line_hash
+        {
+            auto operator()(std::string_view line) const -> std::size_t
+            {
+                return static_cast<std::size_t>(fnv1a_64(line));
+            }
+        };
+
+        // Produced lines count up, recorded lines count down
+        std::unordered_map<std::string_view, std::int64_t, line_hash> counts;
+        for_each_line(data, [&counts](std::string_view line)
+                      { ++counts[line]; });
+        for_each_line(recording, [&counts](std::string_view line)
+                      { --counts[line]; });
+
+        // Report the lines in the order they appear, each line once
+        auto describe = [&counts, max_lines](std::string_view side,
+                                             std::int64_t sign,
+                                             std::size_t& total)
+        {
+            std::string lines;
+            std::size_t listed = 0;
+            for_each_line(
+                side,
+                [&](std::string_view line)
+                {
+                    auto it = counts.find(line);
+                    std::int64_t count = it->second * sign;
+                    if (count <= 0)
+                    {
+                        return;
+                    }
+                    total += count;
+                    if (listed++ < max_lines)
+                    {
+                        lines += "\n  ";
+                        append_json_string(lines, line);
+                        if (count > 1)
+                        {
+                            lines += " (" + std::to_string(count) + " times)";
+                        }
+                    }
+                    // Only report the line once
+                    it->second = 0;
+                });
+            if (listed > max_lines)
+            {
+                lines += "\n  ... " + std::to_string(listed - max_lines) +
+                         " more";
+            }
+            return lines;
+        };
+
+        std::size_t surplus = 0;
+        std::size_t missing = 0;
+        std::string surplus_lines = describe(data, 1, surplus);
+        std::string missing_lines = describe(recording, -1, missing);
+
+        if (surplus == 0 && missing == 0)
+        {
+            return {};
+        }
+
+        std::string description;
+        if (surplus > 0)
+        {
+            description += std::to_string(surplus) +
+                           " surplus line(s) not in the recording:" +
+                           surplus_lines;
+        }
+        if (missing > 0)
+        {
+            description += description.empty() ? "" : "\n";
+            description += std::to_string(missing) +
+                           " line(s) missing from the recording:" +
+                           missing_lines;
+        }
+        return tl::make_unexpected(description);
+    };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <tl/expected.hpp>
+#include <verify/verify.hpp>
+
+#include "hash.hpp"
+#include "manifest.hpp"
+
+namespace datarecorder
+{
+
+/// A recording used by a test
+struct journal_entry
+{
+    /// The name of the test, empty if it is not known
+    std::string test;
+
+    /// The path of the recording relative to the recording directory, with
+    /// "/" separators
+    std::string recording;
+
+    /// The FNV-1a hash of the recording when the test used it
+    std::uint64_t hash = 0;
+};
+
+/// Return the entry as a "<test>\t<recording>\t<hash>" line
+inline auto format_journal_entry(const journal_entry& entry) -> std::string
+{
+    return entry.test + "\t" + entry.recording + "\t" + to_hex(entry.hash) +
+           "\n";
+}
+
+/// Parse a journal of lines written by format_journal_entry()
+inline auto parse_journal(std::string_view text)
+    -> tl::expected<std::vector<journal_entry>, std::string>
+{
+    std::vector<journal_entry> journal;
+    std::size_t line_number = 0;
+    while (!text.empty())
+    {
+        ++line_number;
+        std::size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::size_t first = line.find('\t');
+        std::size_t last = line.rfind('\t');
+        if (first == last || line.size() - last != 17)
+        {
+            return tl::make_unexpected("invalid journal line " +
+                                       std::to_string(line_number));
+        }
+
+        journal_entry entry;
+        std::string hash(line.substr(last + 1));
+        char* hash_end = nullptr;
+        entry.hash = std::strtoull(hash.c_str(), &hash_end, 16);
+        entry.test = std::string(line.substr(0, first));
+        entry.recording = std::string(line.substr(first + 1, last - first - 1));
+        if (*hash_end != '\0' || entry.recording.empty())
+        {
+            return tl::make_unexpected("invalid journal line " +
+                                       std::to_string(line_number));
+        }
+        journal.push_back(std::move(entry));
+    }
+    return journal;
+}
+
+/// Return the recordings no entry of the journal used, sorted
+inline auto orphaned_recordings(const std::vector<std::string>& recordings,
+                                const std::vector<journal_entry>& journal)
+    -> std::vector<std::string>
+{
+    std::set<std::string_view> used;
+    for (const auto& entry : journal)
+    {
+        used.insert(entry.recording);
+    }
+
+    std::vector<std::string> orphans;
+    for (const auto& recording : recordings)
+    {
+        if (used.count(recording) == 0)
+        {
+            orphans.push_back(recording);
+        }
+    }
+    std::sort(orphans.begin(), orphans.end());
+    return orphans;
+}
+
+/// Return the tests that used a recording which has changed or was removed
+/// since, sorted. If a test used a recording several times, the last entry
+/// of the journal counts.
+inline auto affected_tests(const std::vector<journal_entry>& journal,
+                           const std::vector<manifest_entry>& manifest)
+    -> std::vector<std::string>
+{
+    std::map<std::string_view, std::uint64_t> current;
+    for (const auto& entry : manifest)
+    {
+        current[entry.path] = entry.hash;
+    }
+
+    std::map<std::pair<std::string_view, std::string_view>, std::uint64_t>
+        used;
+    for (const auto& entry : journal)
+    {
+        used[{entry.test, entry.recording}] = entry.hash;
+    }
+
+    std::set<std::string> tests;
+    for (const auto& [key, hash] : used)
+    {
+        auto it = current.find(key.second);
+        if (!key.first.empty() && (it == current.end() || it->second != hash))
+        {
+            tests.emplace(key.first);
+        }
+    }
+    return {tests.begin(), tests.end()};
+}
+
+/// Appends the recordings used by the tests of a run to a journal file.
+///
+/// From the journal the datarecorder command line tool lists the orphaned
+/// recordings no test uses, and the tests affected by changed recordings,
+/// so only those need to run.
+///
+/// The file is opened in append mode and every entry is written with a
+/// single write, so the test processes of a parallel run can share one
+/// journal.
+///
+/// Example:
+///     datarecorder::usage_journal journal("usage.journal");
+///     recorder.set_usage_journal(journal);
+///
+/// Alternatively set the DATARECORDER_JOURNAL environment variable to the
+/// path of the journal to use it for all recorders.
+class usage_journal
+{
+public:
+    /// The process-wide journal at the path in the DATARECORDER_JOURNAL
+    /// environment variable, or nullptr if it is not set
+    static auto instance() -> usage_journal*
+    {
+        static usage_journal* instance = []() -> usage_journal*
+        {
+            const char* path = std::getenv("DATARECORDER_JOURNAL");
+            if (path == nullptr || *path == '\0')
+            {
+                return nullptr;
+            }
+            static usage_journal journal(path);
+            return &journal;
+        }();
+        return instance;
+    }
+
+    /// Open the journal for appending
+    explicit usage_journal(const std::filesystem::path& path) :
+        m_path(path)
+    {
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path());
+        }
+        m_file.open(path, std::ios::binary | std::ios::app);
+        VERIFY(m_file.is_open(), "Failed to open journal", path.string());
+    }
+
+    usage_journal(const usage_journal&) = delete;
+    usage_journal& operator=(const usage_journal&) = delete;
+
+    /// Append an entry to the journal
+    void add(const journal_entry& entry)
+    {
+        std::string line = format_journal_entry(entry);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_file.write(line.data(), line.size());
+        m_file.flush();
+    }
+
+    /// The path of the journal
+    auto path() const -> const std::filesystem::path&
+    {
+        return m_path;
+    }
+
+private:
+    std::filesystem::path m_path;
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pattern.hpp"
+#include "storage.hpp"
+
+namespace datarecorder
+{
+
+/// Write the data to the output with every "${...}" escaped as "\${...}".
+/// The data is inserted in a javascript template literal in the visualizer,
+/// where "${...}" would otherwise be interpreted as a substitution.
+inline void escape_dollar_bracs(std::ostream& out, std::string_view data)
+{
+    static constexpr pattern dollar_brace("\\$\\{[^}]+\\}");
+
+    std::size_t position = 0;
+    while (true)
+    {
+        auto [match, length] = dollar_brace.find(data, position);
+        if (match == std::string_view::npos)
+        {
+            break;
+        }
+        out.write(data.data() + position, match - position);
+        out << '\\';
+        out.write(data.data() + match, length);
+        position = match + length;
+    }
+    out.write(data.data() + position, data.size() - position);
+}
+
+/// The diff visualizer template split into its static text and the two
+/// slots where the recording data ("oldText") and the produced data
+/// ("newText") are inserted.
+///
+/// Templates are immutable once constructed and shared through load(), so
+/// the template file is read and parsed once per process no matter how many
+/// recorders hit a mismatch.
+class visualizer_template
+{
+public:
+    /// The slots that can be filled in the template
+    enum class slot
+    {
+        recording_data,
+        mismatch_data
+    };
+
+    /// Return the template at the path, reading and splitting it on first
+    /// use. The template is cached for the lifetime of the process.
+    static auto load(const std::filesystem::path& path)
+        -> std::shared_ptr<const visualizer_template>
+    {
+        static std::mutex mutex;
+        static std::map<std::filesystem::path,
+                        std::shared_ptr<const visualizer_template>>
+            cache;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto& cached = cache[path];
+        if (!cached)
+        {
+            cached = std::make_shared<const visualizer_template>(
+                read_file(path));
+        }
+        return cached;
+    }
+
+    /// Constructor splitting the template content. The slots are the
+    /// contents of the "const oldText = `...`;" and "const newText = `...`;"
+    /// template literals.
+    explicit visualizer_template(const std::string& content)
+    {
+        static const std::regex old_text_pattern(
+            R"((const\s+oldText\s*=\s*`)([^`]*)(`;))");
+        static const std::regex new_text_pattern(
+            R"((const\s+newText\s*=\s*`)([^`]*)(`;))");
+
+        // Find the position of every slot in the template
+        struct match
+        {
+            std::size_t position;
+            std::size_t length;
+            slot type;
+        };
+        std::vector<match> matches;
+
+        auto find = [&](const std::regex& pattern, slot type)
+        {
+            for (auto it = std::sregex_iterator(content.begin(), content.end(),
+                                                pattern);
+                 it != std::sregex_iterator(); ++it)
+            {
+                matches.push_back(
+                    {static_cast<std::size_t>(it->position(2)),
+                     static_cast<std::size_t>(it->length(2)), type});
+            }
+        };
+        find(old_text_pattern, slot::recording_data);
+        find(new_text_pattern, slot::mismatch_data);
+
+        std::sort(matches.begin(), matches.end(),
+                  [](const match& a, const match& b)
+                  { return a.position < b.position; });
+
+        // Keep the text between the slots
+        std::size_t position = 0;
+        for (const auto& m : matches)
+        {
+            m_texts.push_back(content.substr(position, m.position - position));
+            m_slots.push_back(m.type);
+            position = m.position + m.length;
+        }
+        m_texts.push_back(content.substr(position));
+    }
+
+    /// Write the template with the slots filled by the given writer. The
+    /// writer is called as writer(out, slot) for every slot in the template.
+    template <class Writer>
+    void write(std::ostream& out, Writer&& writer) const
+    {
+        for (std::size_t i = 0; i < m_slots.size(); ++i)
+        {
+            out << m_texts[i];
+            writer(out, m_slots[i]);
+        }
+        out << m_texts.back();
+    }
+
+    /// Return the number of slots found in the template
+    auto slots() const -> std::size_t
+    {
+        return m_slots.size();
+    }
+
+private:
+    /// The static text, one more than the number of slots
+    std::vector<std::string> m_texts;
+
+    /// The slots in the order they appear in the template
+    std::vector<slot> m_slots;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include "comparator.hpp"
+#include "json_string.hpp"
+
+namespace datarecorder
+{
+
+/// The whitespace differences ignored by whitespace_comparator()
+struct whitespace_options
+{
+    /// Ignore a carriage return before a newline or at the end i.e. CRLF
+    /// equals LF
+    bool ignore_carriage_returns = true;
+
+    /// Ignore spaces and tabs at the end of lines
+    bool ignore_trailing_whitespace = true;
+
+    /// Ignore whether the data ends with a newline
+    bool ignore_final_newline = true;
+};
+
+/// Return a comparator that ignores the whitespace differences selected by
+/// the options, such as those of a recording edited on Windows.
+///
+/// Both sides are scanned line by line with a cursor each and the lines are
+/// trimmed by adjusting their views, so no normalized copies are made and
+/// every line is compared with a single memcmp.
+///
+/// Example:
+///     recorder.set_comparator(datarecorder::whitespace_comparator());
+inline auto whitespace_comparator(whitespace_options options = {})
+    -> comparator
+{
+    return [options](std::string_view data, std::string_view recording)
+               -> tl::expected<void, std::string>
+    {
+        if (data == recording)
+        {
+            return {};
+        }
+
+        // Return the next line starting at the cursor and move the cursor
+        // past it
+        auto next_line = [&options](std::string_view side,
+                                    std::size_t& cursor) -> std::string_view
+        {
+            const void* newline = std::memchr(side.data() + cursor, '\n',
+                                              side.size() - cursor);
+            std::size_t end = newline == nullptr
+                                  ? side.size()
+                                  : static_cast<const char*>(newline) -
+                                        side.data();
+            std::string_view line = side.substr(cursor, end - cursor);
+            cursor = end + 1;
+
+            if (options.ignore_carriage_returns && !line.empty() &&
+                line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            if (options.ignore_trailing_whitespace)
+            {
+                while (!line.empty() &&
+                       (line.back() == ' ' || line.back() == '\t'))
+                {
+                    line.remove_suffix(1);
+                }
+            }
+            return line;
+        };
+
+        auto quote = [](std::string_view text)
+        {
+            std::string quoted;
+            append_json_string(quoted, text);
+            return quoted;
+        };
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        std::size_t line = 1;
+        for (; i < data.size() && j < recording.size(); ++line)
+        {
+            std::string_view a = next_line(data, i);
+            std::string_view b = next_line(recording, j);
+            if (a != b)
+            {
+                return tl::make_unexpected("line " + std::to_string(line) +
+                                           " is " + quote(a) +
+                                           ", the recording has " + quote(b));
+            }
+        }
+
+        if (i < data.size())
+        {
+            return tl::make_unexpected("line " + std::to_string(line) + " " +
+                                       quote(next_line(data, i)) +
+                                       " is not in the recording");
+        }
+        if (j < recording.size())
+        {
+            return tl::make_unexpected(
+                "line " + std::to_string(line) + " " +
+                quote(next_line(recording, j)) +
+                " of the recording is missing");
+        }
+
+        if (!options.ignore_final_newline)
+        {
+            auto ends_with_newline = [](std::string_view side)
+            { return !side.empty() && side.back() == '\n'; };
+
+            if (ends_with_newline(data) != ends_with_newline(recording))
+            {
+                return tl::make_unexpected(std::string(
+                    ends_with_newline(data)
+                        ? "data ends with a newline, the recording does not"
+                        : "recording ends with a newline, the data does not"));
+            }
+        }
+        return {};
+    };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace datarecorder_test
+{
+/// A temporary directory owned by one test. The name holds the process id
+/// and a random suffix such that tests running in parallel processes, e.g.
+/// with ctest -j or in concurrent CI jobs, never share a directory. The
+/// directory and its content are removed when the object goes out of
+/// scope, after restoring the working directory if enter() was called.
+class temp_dir
+{
+public:
+    /// Create the directory "datarecorder_<name>-<pid>-<suffix>" in the
+    /// temporary directory of the system
+    explicit temp_dir(const std::string& name)
+    {
+#if defined(_WIN32)
+        auto pid = static_cast<std::uint64_t>(_getpid());
+#else
+        auto pid = static_cast<std::uint64_t>(getpid());
+#endif
+        std::random_device device;
+        std::uniform_int_distribution<std::uint32_t> random;
+        std::ostringstream directory;
+        directory << "datarecorder_" << name << "-" << pid << "-" << std::hex
+                  << random(device);
+
+        m_path = std::filesystem::temp_directory_path() / directory.str();
+        std::filesystem::create_directories(m_path);
+    }
+
+    temp_dir(const temp_dir&) = delete;
+    auto operator=(const temp_dir&) -> temp_dir& = delete;
+
+    ~temp_dir()
+    {
+        std::error_code error;
+        if (!m_previous_path.empty())
+        {
+            std::filesystem::current_path(m_previous_path, error);
+        }
+        std::filesystem::remove_all(m_path, error);
+    }
+
+    /// Make the directory the working directory until the object goes out
+    /// of scope
+    void enter()
+    {
+        if (m_previous_path.empty())
+        {
+            m_previous_path = std::filesystem::current_path();
+        }
+        std::filesystem::current_path(m_path);
+    }
+
+    /// @return The path of the directory
+    auto path() const -> const std::filesystem::path&
+    {
+        return m_path;
+    }
+
+private:
+    std::filesystem::path m_path;
+    std::filesystem::path m_previous_path;
+};
+}
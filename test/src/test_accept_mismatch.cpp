@@ -0,0 +1,116 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/accept_mismatch.hpp>
+#include <datarecorder/datarecorder.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+
+#include "temp_dir.hpp"
+
+namespace
+{
+/// Keep the reported mismatch and write its produced data to the mismatch
+/// directory, like the mismatch handlers do
+void keep_mismatch(datarecorder::datarecorder& recorder,
+                   std::optional<datarecorder::mismatch_info>& reported,
+                   const std::filesystem::path& mismatch_dir)
+{
+    recorder.on_mismatch(
+        [&reported, mismatch_dir](datarecorder::mismatch_info mismatch)
+        {
+            datarecorder::write_binary_file(
+                mismatch_dir / mismatch.recording_path.filename(),
+                mismatch.mismatch_data);
+            reported = mismatch;
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description", mismatch.description});
+        });
+}
+}
+
+TEST(accept_mismatch, variant)
+{
+    datarecorder_test::temp_dir temp("accept_variant");
+    const std::filesystem::path& dir = temp.path();
+
+    std::optional<datarecorder::mismatch_info> reported;
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir / "recordings");
+    recorder.set_recording_filename("family.data");
+    keep_mismatch(recorder, reported, dir / "mismatch");
+
+    EXPECT_TRUE(recorder.record_variant("rate.1", "a\nb\nc\n"));
+    EXPECT_FALSE(recorder.record_variant("rate.1", "a\nB\nc\n"));
+    ASSERT_TRUE(reported.has_value());
+
+    std::filesystem::path delta_path =
+        dir / "recordings" / "family.data.rate.1.delta";
+    EXPECT_EQ(reported->recording_path, delta_path);
+    EXPECT_EQ(datarecorder::variant_base(delta_path),
+              dir / "recordings" / "family.data");
+
+    // The variant is stored as a delta again and matches the accepted data
+    EXPECT_TRUE(datarecorder::accept_mismatch(
+        dir / "mismatch" / delta_path.filename(), delta_path));
+    EXPECT_EQ(datarecorder::read_binary_file(delta_path).substr(0, 4),
+              "DRD1");
+    EXPECT_TRUE(recorder.record_variant("rate.1", "a\nB\nc\n"));
+    EXPECT_EQ(datarecorder::read_file(dir / "recordings" / "family.data"),
+              "a\nb\nc\n");
+}
+
+TEST(accept_mismatch, checksums_and_header)
+{
+    datarecorder_test::temp_dir temp("accept_checksums");
+    const std::filesystem::path& dir = temp.path();
+
+    std::optional<datarecorder::mismatch_info> reported;
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir / "recordings");
+    recorder.set_recording_filename("checked.data");
+    recorder.enable_recording_header();
+    recorder.enable_checksums();
+    keep_mismatch(recorder, reported, dir / "mismatch");
+
+    EXPECT_TRUE(recorder.record("line\n"));
+    EXPECT_FALSE(recorder.record("other line\n"));
+    ASSERT_TRUE(reported.has_value());
+
+    std::filesystem::path recording_path = dir / "recordings" / "checked.data";
+    EXPECT_TRUE(datarecorder::accept_mismatch(
+        dir / "mismatch" / "checked.data", recording_path));
+
+    // The header and the trailer are written again
+    std::string recording = datarecorder::read_binary_file(recording_path);
+    EXPECT_TRUE(datarecorder::has_recording_header(recording));
+    EXPECT_TRUE(datarecorder::has_checksum_trailer(recording));
+    auto payload = datarecorder::recording_payload(recording);
+    ASSERT_TRUE(payload);
+    EXPECT_EQ(*payload, "other line\n");
+    EXPECT_TRUE(recorder.record("other line\n"));
+}
+
+TEST(accept_mismatch, corrupt_base)
+{
+    datarecorder_test::temp_dir temp("accept_corrupt_base");
+    const std::filesystem::path& dir = temp.path();
+
+    std::string base = "a\n";
+    datarecorder::append_checksum_trailer(base);
+    base[0] = 'b';
+    datarecorder::write_binary_file(dir / "base.data", base);
+    datarecorder::write_binary_file(dir / "base.data.v.delta", "old");
+    datarecorder::write_binary_file(dir / "mismatch", "new\n");
+
+    // The variant is left untouched
+    EXPECT_FALSE(datarecorder::accept_mismatch(dir / "mismatch",
+                                               dir / "base.data.v.delta"));
+    EXPECT_EQ(datarecorder::read_binary_file(dir / "base.data.v.delta"),
+              "old");
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/archive.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "temp_dir.hpp"
+
+TEST(archive, pack_unpack)
+{
+    datarecorder_test::temp_dir temp("archive");
+    const std::filesystem::path& dir = temp.path();
+    datarecorder::write_file(dir / "in" / "a.data", "recording a\n");
+    datarecorder::write_binary_file(dir / "in" / "sub" / "b.data",
+                                    std::string("\0\1\2", 3));
+
+    std::string archive = datarecorder::pack(dir / "in");
+    auto files = datarecorder::unpack(archive, dir / "out");
+    ASSERT_TRUE(files);
+    EXPECT_EQ(*files, 2U);
+    EXPECT_EQ(datarecorder::read_file(dir / "out" / "a.data"),
+              "recording a\n");
+    EXPECT_EQ(datarecorder::read_binary_file(dir / "out" / "sub" / "b.data"),
+              std::string("\0\1\2", 3));
+
+    // A corrupt or truncated archive writes nothing
+    std::string corrupt = archive;
+    corrupt.back() ^= 1;
+    EXPECT_FALSE(datarecorder::unpack(corrupt, dir / "corrupt"));
+    EXPECT_FALSE(datarecorder::unpack(archive.substr(0, archive.size() - 1),
+                                      dir / "corrupt"));
+    EXPECT_FALSE(std::filesystem::exists(dir / "corrupt"));
+}
+
+TEST(archive, rejects_escaping_paths)
+{
+    std::string archive = "DRP1";
+    datarecorder::append_varint(archive, 9);
+    archive += "../x.data";
+    datarecorder::append_varint(archive, 0);
+    datarecorder::append_le(archive, datarecorder::fnv1a_64(""));
+
+    auto result = datarecorder::unpack(archive, "unused");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "invalid path in archive: ../x.data");
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cmath>
+#include <cstdint>
+#include <datarecorder/array_recording.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <vector>
+
+TEST(array_recording, encode_decode)
+{
+    std::vector<std::int16_t> values = {1, -2, 300, -32768};
+    std::string encoded =
+        datarecorder::encode_array(values.data(), values.size());
+
+    ASSERT_EQ(encoded.size(), datarecorder::array_header_size + 8);
+    EXPECT_EQ(encoded.substr(0, 4), "DRA1");
+
+    // Little-endian on every host
+    EXPECT_EQ(static_cast<unsigned char>(encoded[20]), 0x2c);
+    EXPECT_EQ(static_cast<unsigned char>(encoded[21]), 0x01);
+
+    auto decoded = datarecorder::decode_array<std::int16_t>(encoded);
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(*decoded, values);
+
+    auto wrong_type = datarecorder::decode_array<std::uint16_t>(encoded);
+    ASSERT_FALSE(wrong_type);
+    EXPECT_NE(wrong_type.error().find("int16"), std::string::npos);
+
+    EXPECT_FALSE(datarecorder::decode_array<std::int16_t>("DRA1"));
+    EXPECT_FALSE(datarecorder::decode_array<std::int16_t>(
+        encoded.substr(0, encoded.size() - 1)));
+}
+
+TEST(array_recording, compare)
+{
+    std::vector<double> recorded = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> produced = {1.0, 2.0005, 3.25, 4.0};
+
+    auto encode = [](const std::vector<double>& values)
+    { return datarecorder::encode_array(values.data(), values.size()); };
+
+    datarecorder::tolerance tolerance;
+    tolerance.absolute = 1e-3;
+    auto compare = datarecorder::array_comparator<double>(tolerance);
+
+    EXPECT_TRUE(compare(encode(recorded), encode(recorded)));
+
+    auto result = compare(encode(produced), encode(recorded));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().find("element 2 deviates most"), 0U);
+    EXPECT_NE(result.error().find("1 of 4 elements"), std::string::npos);
+    EXPECT_NE(result.error().find("worst error 0.25"), std::string::npos);
+
+    tolerance.absolute = 0.5;
+    EXPECT_TRUE(datarecorder::array_comparator<double>(tolerance)(
+        encode(produced), encode(recorded)));
+
+    // Same NaNs are equal
+    std::vector<double> nan = {std::numeric_limits<double>::quiet_NaN()};
+    EXPECT_TRUE(compare(encode(nan), encode(nan)));
+
+    // Different sizes
+    auto sizes = compare(encode({1.0}), encode(recorded));
+    ASSERT_FALSE(sizes);
+    EXPECT_EQ(sizes.error(), "array has 1 elements, the recording has 4");
+}
+
+TEST(array_recording, large_integers)
+{
+    // Values above 2^53 that differ by one are equal as doubles
+    std::vector<std::int64_t> recorded = {1700000000000000000};
+    std::vector<std::int64_t> produced = {1700000000000000001};
+
+    auto compare = datarecorder::array_comparator<std::int64_t>({});
+    auto result =
+        compare(datarecorder::encode_array(produced.data(), produced.size()),
+                datarecorder::encode_array(recorded.data(), recorded.size()));
+    ASSERT_FALSE(result);
+    EXPECT_NE(result.error().find("worst error 1"), std::string::npos);
+    EXPECT_NE(result.error().find("it is 1700000000000000001 and the "
+                                  "recording has 1700000000000000000"),
+              std::string::npos);
+
+    datarecorder::tolerance tolerance;
+    EXPECT_FALSE(datarecorder::within_tolerance<std::uint64_t>(
+        18446744073709551615U, 18446744073709551614U, tolerance));
+    EXPECT_FALSE(datarecorder::within_tolerance<std::int64_t>(
+        std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max(), tolerance));
+    tolerance.absolute = 1.0;
+    EXPECT_TRUE(datarecorder::within_tolerance<std::uint64_t>(
+        18446744073709551615U, 18446744073709551614U, tolerance));
+    EXPECT_FALSE(datarecorder::within_tolerance<std::int64_t>(
+        std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max(), tolerance));
+    tolerance.absolute = 1e30;
+    EXPECT_TRUE(datarecorder::within_tolerance<std::int64_t>(
+        std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max(), tolerance));
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/artifact_budget.hpp>
+#include <gtest/gtest.h>
+
+TEST(artifact_budget, reserve)
+{
+    datarecorder::artifact_budget budget;
+    budget.set_limits(2, 100);
+
+    EXPECT_TRUE(budget.reserve(60));
+    EXPECT_FALSE(budget.reserve(50));
+    EXPECT_TRUE(budget.reserve(40));
+    EXPECT_FALSE(budget.reserve(0));
+
+    EXPECT_EQ(budget.sets(), 2U);
+    EXPECT_EQ(budget.bytes(), 100U);
+    EXPECT_EQ(budget.suppressed(), 2U);
+    EXPECT_NE(budget.report().find("2 suppressed"), std::string::npos);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/checksum_trailer.hpp>
+#include <datarecorder/crc32c.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(crc32c, check_values)
+{
+    EXPECT_EQ(datarecorder::crc32c(""), 0U);
+    EXPECT_EQ(datarecorder::crc32c("123456789"), 0xe3069283U);
+    EXPECT_EQ(datarecorder::crc32c_table("123456789"), 0xe3069283U);
+    EXPECT_EQ(datarecorder::crc32c_hardware("123456789"), 0xe3069283U);
+    EXPECT_EQ(datarecorder::crc32c(std::string(32, '\0')), 0x8a9136aaU);
+    EXPECT_EQ(datarecorder::crc32c(std::string(32, '\xff')), 0x62a8ab43U);
+}
+
+TEST(crc32c, implementations_agree)
+{
+    std::string data;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        data += static_cast<char>((i * 7919) >> 3);
+    }
+
+    // Every length and alignment, and continuing from a previous CRC
+    for (std::size_t offset = 0; offset < 8; ++offset)
+    {
+        for (std::size_t size = 0; size + offset <= 100; ++size)
+        {
+            std::string_view view(data.data() + offset, size);
+            std::uint32_t expected = datarecorder::crc32c_table(view);
+            if (datarecorder::crc32c_hardware_available())
+            {
+                EXPECT_EQ(datarecorder::crc32c_hardware(view), expected);
+            }
+            EXPECT_EQ(datarecorder::crc32c(view.substr(size / 2),
+                                           datarecorder::crc32c(
+                                               view.substr(0, size / 2))),
+                      expected);
+        }
+    }
+}
+
+TEST(crc32c, checksum_trailer)
+{
+    std::string data = "recorded output\n";
+    EXPECT_FALSE(datarecorder::has_checksum_trailer(data));
+    EXPECT_EQ(*datarecorder::verify_checksum_trailer(data), data);
+
+    std::string with_trailer = data;
+    datarecorder::append_checksum_trailer(with_trailer);
+    EXPECT_EQ(with_trailer.size(),
+              data.size() + datarecorder::checksum_trailer_size);
+    EXPECT_TRUE(datarecorder::has_checksum_trailer(with_trailer));
+    EXPECT_EQ(*datarecorder::verify_checksum_trailer(with_trailer), data);
+
+    // A flipped bit in the content is caught
+    with_trailer[3] ^= 0x10;
+    EXPECT_FALSE(datarecorder::verify_checksum_trailer(with_trailer));
+
+    // Data that only ends with the magic has no trailer
+    EXPECT_FALSE(datarecorder::has_checksum_trailer(
+        "0123456789abcdef0123456789abDRC1"));
+}
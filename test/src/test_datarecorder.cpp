@@ -3,11 +3,21 @@
 //
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
+#include <datarecorder/check_recording.hpp>
 #include <datarecorder/datarecorder.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "temp_dir.hpp"
 
 TEST(datarecorder, record_string)
 {
@@ -66,3 +76,522 @@ TEST(datarecorder, mismatch_directory_only_created_when_needed)
     // No new directories should have been created
     EXPECT_EQ(initial_count, final_count);
 }
+
+TEST(datarecorder, diff_mismatch_handler_writes_hunks)
+{
+    // Run from a temporary directory with a visualizer such that the diff
+    // mismatch handler is used
+    datarecorder_test::temp_dir temp("diff_handler");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::create_directories(dir / "recordings");
+    datarecorder::write_file(dir / "visualizer" / "recording_diff.html",
+                             "const oldText = ``;\nconst newText = ``;\n");
+    temp.enter();
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir / "recordings");
+    recorder.set_recording_filename("diff.data");
+    recorder.set_inline_diff_limit(14);
+
+    EXPECT_TRUE(recorder.record("a\nb\nc\n"));
+
+    // Small mismatches are inlined in the visualizer
+    std::filesystem::path mismatch_dir = datarecorder::next_mismatch_dir();
+    EXPECT_FALSE(recorder.record("a\nB\nc\n"));
+    EXPECT_EQ(datarecorder::read_file(mismatch_dir / "recording_diff.html"),
+              "const oldText = `a\nb\nc\n`;\nconst newText = `a\nB\nc\n`;\n");
+    EXPECT_FALSE(
+        std::filesystem::exists(mismatch_dir / "recording_diff.hunks.js"));
+    EXPECT_FALSE(
+        std::filesystem::exists(mismatch_dir / "recording_hunks.html"));
+    std::filesystem::remove_all(mismatch_dir);
+
+    // Large mismatches are only written as hunks
+    mismatch_dir = datarecorder::next_mismatch_dir();
+    EXPECT_FALSE(recorder.record("a\nb\nc\nd\ne\n"));
+    EXPECT_FALSE(std::filesystem::exists(mismatch_dir / "recording_diff.html"));
+    std::string hunks =
+        datarecorder::read_file(mismatch_dir / "recording_diff.hunks.js");
+    EXPECT_NE(hunks.find("\"ops\": \"   ++\""), std::string::npos);
+    EXPECT_TRUE(std::filesystem::exists(mismatch_dir / "recording_hunks.html"));
+    EXPECT_EQ(datarecorder::read_file(mismatch_dir / "diff.data"),
+              "a\nb\nc\nd\ne\n");
+    std::filesystem::remove_all(mismatch_dir);
+}
+
+TEST(datarecorder, artifact_budget_exhausted)
+{
+    datarecorder_test::temp_dir temp("budget");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::create_directories(dir / "recordings");
+    datarecorder::write_file(dir / "visualizer" / "recording_diff.html",
+                             "const oldText = ``;\nconst newText = ``;\n");
+    temp.enter();
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir / "recordings");
+    recorder.set_recording_filename("budget.data");
+
+    // Restore the limits that were active before the test on scope exit
+    struct budget_guard
+    {
+        std::size_t max_sets =
+            datarecorder::artifact_budget::instance().max_sets();
+        std::uint64_t max_bytes =
+            datarecorder::artifact_budget::instance().max_bytes();
+        ~budget_guard()
+        {
+            datarecorder::set_artifact_budget(max_sets, max_bytes);
+        }
+    } guard;
+    datarecorder::set_artifact_budget(0, 0);
+
+    EXPECT_TRUE(recorder.record("a\n"));
+
+    // Beyond the budget no artifacts are written
+    std::filesystem::path mismatch_dir = datarecorder::next_mismatch_dir();
+    std::size_t suppressed =
+        datarecorder::artifact_budget::instance().suppressed();
+    EXPECT_FALSE(recorder.record("b\n"));
+    EXPECT_FALSE(std::filesystem::exists(mismatch_dir));
+    EXPECT_EQ(datarecorder::artifact_budget::instance().suppressed(),
+              suppressed + 1);
+}
+
+TEST(datarecorder, normalizer)
+{
+    datarecorder::normalizer normalizer;
+    normalizer.replace_pattern("0x[0-9a-f]+", "<address>").mask_numbers();
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.set_normalizer(normalizer);
+
+    EXPECT_TRUE(recorder.record("pid 1234 allocated 0x7ffe10 in 12.5 ms"));
+    EXPECT_TRUE(recorder.record("pid 99 allocated 0x55aa in 0.1 ms"));
+    EXPECT_FALSE(recorder.record("pid 99 freed 0x55aa in 0.1 ms"));
+}
+
+TEST(datarecorder, numeric_comparator)
+{
+    datarecorder::tolerance tolerance;
+    tolerance.ulps = 4;
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.set_comparator(datarecorder::numeric_comparator(tolerance));
+
+    EXPECT_TRUE(recorder.record("gain: 0.1 phase: 0.30000000000000004\n"));
+    EXPECT_TRUE(recorder.record("gain: 0.1 phase: 0.3\n"));
+    EXPECT_FALSE(recorder.record("gain: 0.2 phase: 0.3\n"));
+}
+
+TEST(datarecorder, record_array)
+{
+    std::vector<float> samples(1000);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = std::sin(0.01f * i);
+    }
+
+    datarecorder::tolerance tolerance;
+    tolerance.ulps = 2;
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.on_mismatch(
+        [](datarecorder::mismatch_info mismatch)
+        {
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description:", mismatch.description});
+        });
+
+    EXPECT_TRUE(recorder.record_array(samples, tolerance));
+
+    samples[10] = std::nextafter(samples[10], 2.0f);
+    EXPECT_TRUE(recorder.record_array(samples, tolerance));
+
+    samples[500] += 0.5f;
+    auto result = recorder.record_array(samples, tolerance);
+    ASSERT_FALSE(result);
+    EXPECT_NE(result.error().message().find("element 500"), std::string::npos);
+}
+
+TEST(datarecorder, record_table)
+{
+    datarecorder::table_schema schema;
+    schema.add_column("flow", datarecorder::column_type::integer)
+        .add_column("packets", datarecorder::column_type::integer);
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.on_mismatch(
+        [](datarecorder::mismatch_info mismatch)
+        {
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description:", mismatch.description});
+        });
+
+    datarecorder::table table(schema);
+    table.add_row(1, 100);
+    table.add_row(2, 200);
+    EXPECT_TRUE(recorder.record_table(table));
+
+    datarecorder::table changed(schema);
+    changed.add_row(1, 100);
+    changed.add_row(2, 201);
+    auto result = recorder.record_table(changed);
+    ASSERT_FALSE(result);
+    EXPECT_NE(result.error().message().find("(row 1, column \"packets\")"),
+              std::string::npos);
+}
+
+TEST(datarecorder, record_variant)
+{
+    auto simulate = [](int rate)
+    {
+        std::string data;
+        for (int i = 0; i < 100; ++i)
+        {
+            data += "step " + std::to_string(i) + ": " +
+                    std::to_string(i < 90 ? i : i * rate) + "\n";
+        }
+        return data;
+    };
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.on_mismatch(
+        [](datarecorder::mismatch_info mismatch)
+        {
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description:", mismatch.description});
+        });
+
+    for (int rate = 1; rate <= 3; ++rate)
+    {
+        EXPECT_TRUE(
+            recorder.record_variant("rate_" + std::to_string(rate),
+                                    simulate(rate)));
+    }
+
+    auto result = recorder.record_variant("rate_2", simulate(3));
+    ASSERT_FALSE(result);
+    EXPECT_NE(result.error().message().find("line 91"), std::string::npos);
+}
+
+TEST(datarecorder, record_and_replay_events)
+{
+    datarecorder::event_log log;
+    for (std::uint64_t i = 0; i < 100; ++i)
+    {
+        log.add(i % 2, i, "packet " + std::to_string(i));
+    }
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    EXPECT_TRUE(recorder.record_events(log));
+
+    std::size_t packets = 0;
+    auto stats = recorder.replay_events(
+        [&packets](const datarecorder::event_view& event)
+        { packets += event.channel == 0; });
+    ASSERT_TRUE(stats);
+    EXPECT_EQ(stats->events, 100U);
+    EXPECT_EQ(packets, 50U);
+
+    log.add(0, 100, "late packet");
+    recorder.on_mismatch(
+        [](datarecorder::mismatch_info mismatch)
+        {
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description:", mismatch.description});
+        });
+    EXPECT_FALSE(recorder.record_events(log));
+}
+
+TEST(datarecorder, record_deterministic)
+{
+    datarecorder_test::temp_dir temp("record_deterministic");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::path recording = dir / "output.data";
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir);
+    recorder.set_recording_filename("output.data");
+
+    // Nondeterministic output is not recorded
+    std::atomic<int> calls{0};
+    auto result = recorder.record_deterministic(
+        [&calls] { return "run " + std::to_string(calls++); });
+    EXPECT_FALSE(result);
+    EXPECT_FALSE(std::filesystem::exists(recording));
+
+    EXPECT_TRUE(recorder.record_deterministic([] { return "stable"; }));
+    EXPECT_TRUE(std::filesystem::exists(recording));
+    EXPECT_TRUE(recorder.record_deterministic([] { return "stable"; }));
+}
+
+TEST(datarecorder, name_provider)
+{
+    datarecorder_test::temp_dir temp("name_provider");
+    const std::filesystem::path& dir = temp.path();
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir);
+    recorder.set_name_provider(datarecorder::explicit_name("canary"));
+    EXPECT_TRUE(recorder.record("explicit"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "canary.data"));
+
+    // One recorder follows the scoped names
+    datarecorder::datarecorder scoped;
+    scoped.set_recording_dir(dir);
+    {
+        datarecorder::scoped_name name("scenario_1");
+        EXPECT_TRUE(scoped.record("first"));
+    }
+    {
+        datarecorder::scoped_name name("scenario_2");
+        EXPECT_TRUE(scoped.record("second"));
+    }
+    EXPECT_EQ(datarecorder::read_file(dir / "scenario_1.data"), "first");
+    EXPECT_EQ(datarecorder::read_file(dir / "scenario_2.data"), "second");
+}
+
+TEST(datarecorder, usage_journal)
+{
+    datarecorder_test::temp_dir temp("usage_journal");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::create_directories(dir / "recordings");
+
+    {
+        datarecorder::usage_journal journal(dir / "usage.journal");
+
+        datarecorder::datarecorder recorder;
+        recorder.set_recording_dir(dir / "recordings");
+        recorder.set_name_provider(datarecorder::explicit_name("journaled"));
+        recorder.set_usage_journal(journal);
+
+        // The recording is journaled when it is created and when it is used
+        EXPECT_TRUE(recorder.record("data"));
+        EXPECT_TRUE(recorder.record("data"));
+    }
+
+    auto journal = datarecorder::parse_journal(
+        datarecorder::read_file(dir / "usage.journal"));
+    ASSERT_TRUE(journal);
+    ASSERT_EQ(journal->size(), 2U);
+    EXPECT_EQ((*journal)[0].test, "journaled");
+    EXPECT_EQ((*journal)[0].recording, "journaled.data");
+    EXPECT_EQ((*journal)[0].hash, datarecorder::fnv1a_64("data"));
+}
+
+TEST(datarecorder, concurrent_creation)
+{
+    datarecorder_test::temp_dir temp("concurrent_creation");
+    const std::filesystem::path& dir = temp.path();
+
+    // One recorder creates the recording and the others compare with it
+    std::vector<std::thread> threads;
+    std::vector<int> results(8, 0);
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back(
+            [&dir, &results, i]
+            {
+                datarecorder::datarecorder recorder;
+                recorder.set_recording_dir(dir);
+                recorder.set_recording_filename("shared.data");
+                results[i] = recorder.record("same\n").has_value();
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int result : results)
+    {
+        EXPECT_TRUE(result);
+    }
+    EXPECT_EQ(datarecorder::read_file(dir / "shared.data"), "same\n");
+}
+
+namespace
+{
+/// A memory resource counting the allocations passed to the default
+/// resource
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+
+private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment)
+        -> void* override
+    {
+        ++allocations;
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+}
+
+TEST(datarecorder, memory_resource)
+{
+    datarecorder_test::temp_dir temp("memory");
+    const std::filesystem::path& dir = temp.path();
+
+    datarecorder::normalizer normalizer;
+    normalizer.mask_numbers();
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir);
+    recorder.set_recording_filename("lines.data");
+    recorder.set_normalizer(normalizer);
+
+    std::vector<std::string> lines = {"took 12 ms", "took 13 ms"};
+    EXPECT_TRUE(recorder.record(lines));
+
+    // The buffers are allocated from the memory resource
+    counting_resource resource;
+    recorder.set_memory_resource(&resource);
+    EXPECT_TRUE(recorder.record(lines));
+    EXPECT_GT(resource.allocations, 0U);
+    recorder.set_memory_resource(nullptr);
+
+    // Or from the arena of the thread, which here never falls back to the
+    // heap since the buffer is large enough
+    {
+        alignas(std::max_align_t) std::byte buffer[4096];
+        datarecorder::scoped_arena arena(buffer, sizeof(buffer),
+                                         std::pmr::null_memory_resource());
+        EXPECT_TRUE(recorder.record(lines));
+        EXPECT_TRUE(recorder.record(std::vector<std::string>{"took 1 ms",
+                                                             "took 2 ms"}));
+    }
+}
+
+TEST(datarecorder, checksums)
+{
+    datarecorder_test::temp_dir temp("checksums");
+    const std::filesystem::path& dir = temp.path();
+
+    bool mismatch_reported = false;
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir);
+    recorder.set_recording_filename("checked.data");
+    recorder.enable_checksums();
+    recorder.on_mismatch(
+        [&mismatch_reported](datarecorder::mismatch_info mismatch)
+        {
+            mismatch_reported = true;
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description", mismatch.description});
+        });
+
+    EXPECT_TRUE(recorder.record("line\n"));
+    EXPECT_TRUE(datarecorder::has_checksum_trailer(
+        datarecorder::read_binary_file(dir / "checked.data")));
+    EXPECT_TRUE(recorder.record("line\n"));
+
+    // A corrupt recording is not reported as a mismatch
+    std::string recording =
+        datarecorder::read_binary_file(dir / "checked.data");
+    recording[0] = 'k';
+    datarecorder::write_binary_file(dir / "checked.data", recording);
+    EXPECT_FALSE(recorder.record("line\n"));
+    EXPECT_FALSE(mismatch_reported);
+
+    // Neither is a recording that lost its trailer
+    datarecorder::write_binary_file(dir / "checked.data", "line\n");
+    EXPECT_FALSE(recorder.record("line\n"));
+    EXPECT_FALSE(mismatch_reported);
+
+    // But a changed output is
+    std::filesystem::remove(dir / "checked.data");
+    EXPECT_TRUE(recorder.record("line\n"));
+    EXPECT_FALSE(recorder.record("other\n"));
+    EXPECT_TRUE(mismatch_reported);
+}
+
+TEST(datarecorder, recording_header)
+{
+    datarecorder_test::temp_dir temp("header");
+    const std::filesystem::path& dir = temp.path();
+
+    std::optional<datarecorder::mismatch_info> reported;
+
+    datarecorder::datarecorder recorder;
+    recorder.set_recording_dir(dir);
+    recorder.set_recording_filename("described.data");
+    recorder.enable_recording_header();
+    recorder.enable_checksums();
+    recorder.on_mismatch(
+        [&reported](datarecorder::mismatch_info mismatch)
+        {
+            reported = mismatch;
+            return poke::make_error(
+                std::make_error_code(std::errc::invalid_argument),
+                poke::log::str{"description", mismatch.description});
+        });
+
+    EXPECT_TRUE(recorder.record("line\n"));
+    std::string recording =
+        datarecorder::read_binary_file(dir / "described.data");
+    EXPECT_TRUE(datarecorder::has_recording_header(recording));
+    EXPECT_TRUE(datarecorder::check_recording(recording));
+    EXPECT_TRUE(recorder.record("line\n"));
+
+    // A different size is a mismatch found from the header, reported with
+    // the recorded payload
+    EXPECT_FALSE(recorder.record("longer line\n"));
+    ASSERT_TRUE(reported.has_value());
+    EXPECT_EQ(reported->description,
+              "the data has 12 bytes, the recording header announces 5");
+    EXPECT_EQ(reported->recording_data, "line\n");
+    EXPECT_EQ(reported->mismatch_data, "longer line\n");
+
+    // Data of the same size is compared with the payload
+    reported.reset();
+    EXPECT_FALSE(recorder.record("lime\n"));
+    ASSERT_TRUE(reported.has_value());
+    EXPECT_EQ(reported->recording_data, "line\n");
+
+    // A corrupt payload is never accepted and not reported as a mismatch,
+    // also when the header shows a different size
+    reported.reset();
+    recording[datarecorder::recording_header_size] = 'k';
+    datarecorder::write_binary_file(dir / "described.data", recording);
+    EXPECT_FALSE(recorder.record("line\n"));
+    EXPECT_FALSE(recorder.record("longer line\n"));
+    EXPECT_FALSE(reported.has_value());
+
+    // A truncated payload is caught by the header
+    datarecorder::datarecorder plain;
+    plain.set_recording_dir(dir);
+    plain.set_recording_filename("truncated.data");
+    std::string truncated;
+    datarecorder::append_recording_header(
+        truncated, datarecorder::make_recording_header("line\n"));
+    truncated += "lin";
+    datarecorder::write_binary_file(dir / "truncated.data", truncated);
+    EXPECT_FALSE(plain.record("line\n"));
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <atomic>
+#include <datarecorder/determinism_probe.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+TEST(determinism_probe, deterministic)
+{
+    std::atomic<int> calls{0};
+    auto output = datarecorder::probe_determinism(
+        [&calls]
+        {
+            ++calls;
+            return std::string("same\n");
+        },
+        4);
+    ASSERT_TRUE(output);
+    EXPECT_EQ(*output, "same\n");
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(determinism_probe, varying_ranges)
+{
+    std::atomic<int> calls{0};
+    auto output = datarecorder::probe_determinism(
+        [&calls]
+        {
+            int run = calls++;
+            return "id: " + std::to_string(run) + "\nvalue: 7\nend" +
+                   std::string(run == 3 ? "!" : "");
+        },
+        4);
+    ASSERT_FALSE(output);
+    EXPECT_EQ(output.error(),
+              "3 of 3 runs differ from the first run (output sizes 18, 18, "
+              "18, 19), varying byte ranges:\n"
+              "  bytes [4, 5) at line 1\n"
+              "  bytes [18, 19) at line 3");
+}
+
+TEST(determinism_probe, exceptions_are_rethrown)
+{
+    EXPECT_THROW(datarecorder::probe_determinism(
+                     []() -> std::string
+                     { throw std::runtime_error("producer failed"); },
+                     2),
+                 std::runtime_error);
+}
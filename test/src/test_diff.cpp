@@ -0,0 +1,158 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/diff.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(diff, equal_data_has_no_hunks)
+{
+    auto hunks = datarecorder::diff_lines("a\nb\nc\n", "a\nb\nc\n");
+    EXPECT_TRUE(hunks.empty());
+}
+
+TEST(diff, changed_line)
+{
+    std::string recording = "1\n2\n3\n4\n5\n6\n7\n8\n9\n";
+    std::string mismatch = "1\n2\n3\n4\nfive\n6\n7\n8\n9\n";
+
+    auto hunks = datarecorder::diff_lines(recording, mismatch, 1);
+    ASSERT_EQ(hunks.size(), 1U);
+
+    const auto& hunk = hunks[0];
+    EXPECT_EQ(hunk.recording_line, 3U);
+    EXPECT_EQ(hunk.recording_count, 3U);
+    EXPECT_EQ(hunk.mismatch_line, 3U);
+    EXPECT_EQ(hunk.mismatch_count, 3U);
+    EXPECT_EQ(hunk.recording_offset, 6U);
+    EXPECT_EQ(hunk.mismatch_offset, 6U);
+
+    ASSERT_EQ(hunk.lines.size(), 4U);
+    EXPECT_EQ(hunk.lines[0].op, ' ');
+    EXPECT_EQ(hunk.lines[0].text, "4");
+    EXPECT_EQ(hunk.lines[1].op, '-');
+    EXPECT_EQ(hunk.lines[1].text, "5");
+    EXPECT_EQ(hunk.lines[2].op, '+');
+    EXPECT_EQ(hunk.lines[2].text, "five");
+    EXPECT_EQ(hunk.lines[3].op, ' ');
+    EXPECT_EQ(hunk.lines[3].text, "6");
+}
+
+TEST(diff, separate_hunks)
+{
+    std::string recording = "a\n1\n2\n3\n4\n5\n6\n7\n8\nb\n";
+    std::string mismatch = "A\n1\n2\n3\n4\n5\n6\n7\n8\nB\n";
+
+    auto hunks = datarecorder::diff_lines(recording, mismatch, 2);
+    ASSERT_EQ(hunks.size(), 2U);
+    EXPECT_EQ(hunks[0].recording_line, 0U);
+    EXPECT_EQ(hunks[0].lines.size(), 4U);
+    EXPECT_EQ(hunks[1].recording_line, 7U);
+    EXPECT_EQ(hunks[1].mismatch_line, 7U);
+    EXPECT_EQ(hunks[1].lines.size(), 4U);
+}
+
+TEST(diff, missing_final_newline)
+{
+    auto hunks = datarecorder::diff_lines("a\nb\n", "a\nb");
+    ASSERT_EQ(hunks.size(), 1U);
+    EXPECT_EQ(hunks[0].recording_count, 2U);
+    EXPECT_EQ(hunks[0].mismatch_count, 2U);
+}
+
+TEST(diff, too_many_edits)
+{
+    std::string recording;
+    std::string mismatch;
+    for (int i = 0; i < 100; ++i)
+    {
+        recording += "r" + std::to_string(i) + "\n";
+        mismatch += "m" + std::to_string(i) + "\n";
+    }
+
+    auto hunks = datarecorder::diff_lines(recording, mismatch, 3, 10);
+    ASSERT_EQ(hunks.size(), 1U);
+    EXPECT_EQ(hunks[0].recording_count, 100U);
+    EXPECT_EQ(hunks[0].mismatch_count, 100U);
+    EXPECT_EQ(hunks[0].lines.front().op, '-');
+    EXPECT_EQ(hunks[0].lines.back().op, '+');
+}
+
+TEST(diff, moved_block)
+{
+    // Lines 2-5 of the recording moved to the end
+    std::string recording = "a\nb\nc\nd\ne\nf\ng\nh\ni\nj\n";
+    std::string mismatch = "a\nf\ng\nh\ni\nj\nb\nc\nd\ne\n";
+
+    auto hunks = datarecorder::diff_lines(recording, mismatch, 1);
+    ASSERT_EQ(hunks.size(), 1U);
+    EXPECT_TRUE(hunks[0].moved);
+    EXPECT_EQ(hunks[0].recording_line, 1U);
+    EXPECT_EQ(hunks[0].recording_count, 4U);
+    EXPECT_EQ(hunks[0].recording_offset, 2U);
+    EXPECT_EQ(hunks[0].mismatch_line, 6U);
+    EXPECT_EQ(hunks[0].mismatch_offset, 12U);
+    EXPECT_TRUE(hunks[0].lines.empty());
+    EXPECT_EQ(datarecorder::hunk_header(hunks[0]),
+              "@@ moved lines 2-5 to 7 @@");
+
+    // Without move detection the block is deleted and inserted
+    hunks = datarecorder::diff_lines(recording, mismatch, 1, 2048, 0);
+    ASSERT_EQ(hunks.size(), 2U);
+    EXPECT_FALSE(hunks[0].moved);
+    EXPECT_EQ(hunks[0].lines[1].op, '-');
+    EXPECT_EQ(datarecorder::hunk_header(hunks[0]), "@@ -1,6 +1,2 @@");
+}
+
+TEST(diff, moved_and_changed)
+{
+    std::string recording = "1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n11\n12\n";
+    std::string mismatch = "1\n2\n7\n8\n9\nthree\n4\n5\n6\n10\n11\n12\n";
+
+    auto hunks = datarecorder::diff_lines(recording, mismatch, 1);
+    ASSERT_EQ(hunks.size(), 3U);
+
+    // The changed lines are shown, the moved lines are only covered
+    EXPECT_FALSE(hunks[0].moved);
+    ASSERT_EQ(hunks[0].lines.size(), 2U);
+    EXPECT_EQ(hunks[0].lines[1].op, '-');
+    EXPECT_EQ(hunks[0].lines[1].text, "3");
+    EXPECT_EQ(hunks[0].recording_count, 3U);
+
+    EXPECT_TRUE(hunks[1].moved);
+    EXPECT_EQ(datarecorder::hunk_header(hunks[1]),
+              "@@ moved lines 4-6 to 7 @@");
+
+    EXPECT_FALSE(hunks[2].moved);
+    ASSERT_EQ(hunks[2].lines.size(), 2U);
+    EXPECT_EQ(hunks[2].lines[1].op, '+');
+    EXPECT_EQ(hunks[2].lines[1].text, "three");
+}
+
+TEST(diff, short_blocks_are_not_moves)
+{
+    auto hunks = datarecorder::diff_lines("a\nb\nc\nd\n", "c\nd\na\nb\n");
+    ASSERT_EQ(hunks.size(), 1U);
+    EXPECT_FALSE(hunks[0].moved);
+}
+
+TEST(diff, large_reordered_trace)
+{
+    // Two large blocks swapped, beyond the edit limit of the line diff
+    std::string first;
+    std::string second;
+    for (int i = 0; i < 5000; ++i)
+    {
+        first += "first " + std::to_string(i) + "\n";
+        second += "second " + std::to_string(i) + "\n";
+    }
+
+    auto hunks = datarecorder::diff_lines(first + second, second + first);
+    ASSERT_EQ(hunks.size(), 2U);
+    EXPECT_EQ(datarecorder::hunk_header(hunks[0]),
+              "@@ moved lines 1-5000 to 5001 @@");
+    EXPECT_EQ(datarecorder::hunk_header(hunks[1]),
+              "@@ moved lines 5001-10000 to 1 @@");
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/event_log.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(event_log, round_trip)
+{
+    datarecorder::event_log log;
+    log.add(1, 1000, "packet a");
+    log.add(2, 1010, "");
+    log.add(1, 990, std::string(300, 'x'));
+    EXPECT_EQ(log.events(), 3U);
+
+    std::vector<datarecorder::event_view> events;
+    auto result = datarecorder::for_each_event(
+        log.data(),
+        [&events](const datarecorder::event_view& event)
+        {
+            events.push_back(event);
+            return true;
+        });
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, 3U);
+    ASSERT_EQ(events.size(), 3U);
+    EXPECT_EQ(events[0].channel, 1U);
+    EXPECT_EQ(events[0].time, 1000U);
+    EXPECT_EQ(events[0].payload, "packet a");
+    EXPECT_EQ(events[1].time, 1010U);
+    EXPECT_EQ(events[2].time, 990U);
+    EXPECT_EQ(events[2].payload.size(), 300U);
+
+    std::string truncated = log.data().substr(0, log.data().size() - 1);
+    EXPECT_FALSE(datarecorder::for_each_event(
+        truncated, [](const datarecorder::event_view&) { return true; }));
+}
+
+TEST(event_log, replay)
+{
+    datarecorder::event_log log;
+    for (std::uint64_t i = 0; i < 1000; ++i)
+    {
+        log.add(i % 3, i * 10, "payload");
+    }
+
+    std::size_t handled = 0;
+    auto stats = datarecorder::replay(
+        log.data(), [&handled](const datarecorder::event_view&) { ++handled; });
+    ASSERT_TRUE(stats);
+    EXPECT_EQ(handled, 1000U);
+    EXPECT_EQ(stats->events, 1000U);
+    EXPECT_EQ(stats->bytes, 7000U);
+
+    EXPECT_FALSE(datarecorder::replay("DRE", [](const auto&) {}));
+}
+
+TEST(event_log, compare)
+{
+    datarecorder::event_log recorded;
+    recorded.add(1, 5, "a");
+    recorded.add(2, 6, "b");
+
+    datarecorder::event_log produced;
+    produced.add(1, 5, "a");
+    produced.add(2, 7, "b");
+
+    auto compare = datarecorder::event_log_comparator();
+    EXPECT_TRUE(compare(recorded.data(), recorded.data()));
+
+    auto result = compare(produced.data(), recorded.data());
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "event 1 is channel 2 at time 7 with payload \"b\", the "
+              "recording has channel 2 at time 6 with payload \"b\"");
+
+    produced = recorded;
+    produced.add(3, 8, "c");
+    auto longer = compare(produced.data(), recorded.data());
+    ASSERT_FALSE(longer);
+    EXPECT_EQ(longer.error(), "1 event(s) not in the recording");
+
+    auto shorter = compare(datarecorder::event_log().data(), recorded.data());
+    ASSERT_FALSE(shorter);
+    EXPECT_EQ(shorter.error(),
+              "event 0 channel 1 at time 5 with payload \"a\" is missing");
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/keyed_lines_comparator.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(keyed_lines_comparator, field_key)
+{
+    auto key = datarecorder::field_key(1);
+    EXPECT_EQ(key("seq=1 flow=3 ack"), "flow=3");
+    EXPECT_EQ(key("seq=1 flow=3"), "flow=3");
+    EXPECT_EQ(key("seq=1"), "");
+
+    EXPECT_EQ(datarecorder::field_key(0, ',')("a,b"), "a");
+}
+
+TEST(keyed_lines_comparator, compare)
+{
+    auto compare =
+        datarecorder::keyed_lines_comparator(datarecorder::field_key(0));
+
+    // Flows interleave differently but keep their order
+    EXPECT_TRUE(compare("a 1\nb 1\na 2\nb 2\n", "b 1\nb 2\na 1\na 2\n"));
+
+    auto result = compare("a 2\nb 1\na 1\nb 2\nc 1\n", "a 1\nb 1\na 2\nb 2\n");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "2 key(s) diverge:\n"
+              "  key \"a\": line 1 is \"a 2\", the recording has \"a 1\" at "
+              "line 1\n"
+              "  key \"c\": line 5 \"c 1\" is not in the recording");
+
+    auto missing = compare("a 1\n", "a 1\na 2\n");
+    ASSERT_FALSE(missing);
+    EXPECT_EQ(missing.error(),
+              "1 key(s) diverge:\n"
+              "  key \"a\": line 2 \"a 2\" of the recording is missing");
+}
+
+TEST(keyed_lines_comparator, parallel)
+{
+    std::string data;
+    std::string recording;
+    for (int i = 0; i < 10000; ++i)
+    {
+        std::string flow = std::to_string(i % 64);
+        data += flow + " " + std::to_string(i / 64) + "\n";
+        recording = flow + " " + std::to_string(i / 64) + "\n" + recording;
+    }
+
+    auto compare = datarecorder::keyed_lines_comparator(
+        datarecorder::field_key(0), 10, 4);
+    auto result = compare(data, recording);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().find("64 key(s) diverge:"), 0U);
+    EXPECT_NE(result.error().find("... 54 more"), std::string::npos);
+
+    EXPECT_TRUE(compare(data, data + ""));
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/array_recording.hpp>
+#include <datarecorder/check_recording.hpp>
+#include <datarecorder/manifest.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "temp_dir.hpp"
+
+TEST(manifest, make_format_parse)
+{
+    datarecorder_test::temp_dir temp("manifest");
+    const std::filesystem::path& dir = temp.path();
+    datarecorder::write_file(dir / "b.data", "bb");
+    datarecorder::write_file(dir / "a" / "c.data", "c");
+
+    auto manifest = datarecorder::make_manifest(dir, 2);
+    ASSERT_EQ(manifest.size(), 2U);
+    EXPECT_EQ(manifest[0].path, "a/c.data");
+    EXPECT_EQ(manifest[1].path, "b.data");
+    EXPECT_EQ(manifest[1].size, 2U);
+    EXPECT_EQ(manifest[1].hash, datarecorder::fnv1a_64("bb"));
+
+    std::string text = datarecorder::format_manifest(manifest);
+    auto parsed = datarecorder::parse_manifest(text);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(datarecorder::format_manifest(*parsed), text);
+
+    EXPECT_FALSE(datarecorder::parse_manifest("1234 5 a.data\n"));
+    EXPECT_FALSE(datarecorder::parse_manifest("0123456789abcdef x a\n"));
+}
+
+TEST(manifest, compare_manifests)
+{
+    std::vector<datarecorder::manifest_entry> expected = {
+        {"a.data", 1, 1}, {"b.data", 2, 2}, {"c.data", 3, 3}};
+    std::vector<datarecorder::manifest_entry> actual = {
+        {"a.data", 1, 1}, {"b.data", 2, 7}, {"d.data", 4, 4}};
+
+    EXPECT_EQ(datarecorder::compare_manifests(expected, actual),
+              (std::vector<std::string>{"changed: b.data", "missing: c.data",
+                                        "unexpected: d.data"}));
+    EXPECT_TRUE(datarecorder::compare_manifests(expected, expected).empty());
+}
+
+TEST(manifest, check_recording)
+{
+    std::vector<double> values = {1.0, 2.0};
+    std::string array = datarecorder::encode_array(values.data(), 2);
+
+    EXPECT_TRUE(datarecorder::check_recording("plain text"));
+    EXPECT_TRUE(datarecorder::check_recording(array));
+    EXPECT_FALSE(
+        datarecorder::check_recording(array.substr(0, array.size() - 1)));
+    EXPECT_FALSE(datarecorder::check_recording("DRT1"));
+    EXPECT_FALSE(datarecorder::check_recording("DRE1\x01"));
+
+    // The checksum trailer is verified before the content is decoded
+    datarecorder::append_checksum_trailer(array);
+    EXPECT_TRUE(datarecorder::check_recording(array));
+    array[20] ^= 1;
+    auto corrupt = datarecorder::check_recording(array);
+    ASSERT_FALSE(corrupt);
+    EXPECT_EQ(corrupt.error().find("checksum mismatch"), 0U);
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/mismatch_registry.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+#include "temp_dir.hpp"
+
+TEST(mismatch_registry, fingerprint)
+{
+    datarecorder::mismatch_info a;
+    a.recording_data = "ab";
+    a.mismatch_data = "c";
+
+    datarecorder::mismatch_info b;
+    b.recording_data = "a";
+    b.mismatch_data = "bc";
+
+    EXPECT_NE(datarecorder::mismatch_fingerprint(a),
+              datarecorder::mismatch_fingerprint(b));
+
+    // The paths are not part of the fingerprint
+    b = a;
+    b.recording_path = "other.data";
+    EXPECT_EQ(datarecorder::mismatch_fingerprint(a),
+              datarecorder::mismatch_fingerprint(b));
+}
+
+TEST(mismatch_registry, find_across_runs)
+{
+    datarecorder_test::temp_dir temp("registry_test");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::create_directories(dir / "artifact");
+
+    {
+        datarecorder::mismatch_registry registry;
+        registry.enable_cache(dir / "cache");
+
+        EXPECT_FALSE(registry.find(42));
+        registry.insert(42, dir / "artifact");
+        EXPECT_EQ(registry.find(42), dir / "artifact");
+    }
+
+    // A later run finds the artifact through the cache
+    datarecorder::mismatch_registry registry;
+    EXPECT_FALSE(registry.find(42));
+    registry.enable_cache(dir / "cache");
+    EXPECT_EQ(registry.find(42), dir / "artifact");
+
+    // Artifacts that were removed are not returned
+    std::filesystem::remove_all(dir / "artifact");
+    EXPECT_FALSE(registry.find(42));
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/gtest_name_provider.hpp>
+#include <datarecorder/name_provider.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+TEST(name_provider, explicit_name)
+{
+    EXPECT_EQ(datarecorder::explicit_name("canary")(), "canary");
+}
+
+TEST(name_provider, scoped_name)
+{
+    auto provider = datarecorder::scoped_name_provider();
+    EXPECT_FALSE(provider());
+    {
+        datarecorder::scoped_name outer("outer");
+        EXPECT_EQ(provider(), "outer");
+        {
+            datarecorder::scoped_name inner("inner");
+            EXPECT_EQ(provider(), "inner");
+
+            // Other threads have their own names
+            std::optional<std::string> other;
+            std::thread thread([&] { other = provider(); });
+            thread.join();
+            EXPECT_FALSE(other);
+        }
+        EXPECT_EQ(provider(), "outer");
+    }
+    EXPECT_FALSE(provider());
+}
+
+TEST(name_provider, gtest_name)
+{
+    EXPECT_EQ(datarecorder::gtest_name_provider()(),
+              "name_provider_gtest_name");
+}
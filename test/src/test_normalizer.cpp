@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/normalizer.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(normalizer, rules)
+{
+    datarecorder::normalizer normalizer;
+    normalizer.replace("/tmp/build-42", "<tmp>")
+        .replace_pattern("\\d\\d:\\d\\d:\\d\\d", "<time>")
+        .mask_numbers("N");
+
+    EXPECT_EQ(normalizer.apply("12:30:01 /tmp/build-42/out test1 took 1.5e3 "
+                               "ms at 0x7FFE pid=123"),
+              "<time> <tmp>/out test1 took N ms at N pid=N");
+}
+
+TEST(normalizer, first_rule_wins)
+{
+    datarecorder::normalizer normalizer;
+    normalizer.replace_pattern("0x[0-9a-f]+", "<address>").mask_numbers();
+
+    EXPECT_EQ(normalizer.apply("0x10 10"), "<address> <number>");
+}
+
+TEST(normalizer, equal)
+{
+    datarecorder::normalizer normalizer;
+    normalizer.mask_numbers();
+
+    EXPECT_TRUE(normalizer.equal("pid 42 done", "pid <number> done"));
+    EXPECT_FALSE(normalizer.equal("pid 42 done", "pid <number> don"));
+    EXPECT_FALSE(normalizer.equal("pid 42 done", "pid <number> done!"));
+    EXPECT_FALSE(normalizer.equal("pid 42", "pid 42"));
+    EXPECT_TRUE(normalizer.equal("", ""));
+}
+
+TEST(normalizer, precompiled_pattern)
+{
+    static constexpr datarecorder::pattern pid("pid=\\d+");
+
+    datarecorder::normalizer normalizer;
+    normalizer.replace_pattern(pid, "pid=<pid>");
+
+    EXPECT_EQ(normalizer.apply("a pid=12 b pid= pid=3"),
+              "a pid=<pid> b pid= pid=<pid>");
+}
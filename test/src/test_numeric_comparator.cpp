@@ -0,0 +1,96 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/numeric_comparator.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+
+TEST(numeric_comparator, ulp_distance)
+{
+    double one = 1.0;
+    double next = std::nextafter(one, 2.0);
+    EXPECT_EQ(datarecorder::ulp_distance(one, one), 0U);
+    EXPECT_EQ(datarecorder::ulp_distance(one, next), 1U);
+    EXPECT_EQ(datarecorder::ulp_distance(-0.0, 0.0), 0U);
+    EXPECT_EQ(datarecorder::ulp_distance(
+                  -std::numeric_limits<double>::denorm_min(),
+                  std::numeric_limits<double>::denorm_min()),
+              2U);
+}
+
+TEST(numeric_comparator, number_length)
+{
+    EXPECT_EQ(datarecorder::number_length("x=-1.5e-3,", 2), 7U);
+    EXPECT_EQ(datarecorder::number_length("x=.5", 2), 2U);
+    EXPECT_EQ(datarecorder::number_length("test1", 4), 0U);
+    EXPECT_EQ(datarecorder::number_length("a - b", 2), 0U);
+    EXPECT_EQ(datarecorder::number_length("12e", 0), 2U);
+
+    // A trailing period is not part of the number
+    EXPECT_EQ(datarecorder::number_length("took 5.", 5), 1U);
+    EXPECT_EQ(datarecorder::number_length("took 5.0", 5), 3U);
+}
+
+TEST(numeric_comparator, tolerances)
+{
+    datarecorder::tolerance exact;
+    auto compare_exact = datarecorder::numeric_comparator(exact);
+    EXPECT_TRUE(compare_exact("a 1.0 b", "a 1.0 b"));
+    EXPECT_TRUE(compare_exact("a 1.0 b", "a 1 b"));
+    EXPECT_FALSE(compare_exact("a 1.0 b", "a 1.1 b"));
+
+    datarecorder::tolerance absolute;
+    absolute.absolute = 0.01;
+    auto compare_absolute = datarecorder::numeric_comparator(absolute);
+    EXPECT_TRUE(compare_absolute("x 0.005", "x 0.0"));
+    EXPECT_FALSE(compare_absolute("x 0.02", "x 0.0"));
+
+    datarecorder::tolerance relative;
+    relative.relative = 1e-6;
+    auto compare_relative = datarecorder::numeric_comparator(relative);
+    EXPECT_TRUE(compare_relative("1000000.5", "1000000"));
+    EXPECT_FALSE(compare_relative("1.5", "1"));
+
+    datarecorder::tolerance ulps;
+    ulps.ulps = 2;
+    auto compare_ulps = datarecorder::numeric_comparator(ulps);
+    EXPECT_TRUE(compare_ulps("0.30000000000000004", "0.3"));
+    EXPECT_FALSE(compare_ulps("0.3000000000001", "0.3"));
+}
+
+TEST(numeric_comparator, text_is_exact)
+{
+    datarecorder::tolerance tolerance;
+    tolerance.absolute = 1.0;
+    auto compare = datarecorder::numeric_comparator(tolerance);
+
+    auto result = compare("a 1\nb 2\nc 3", "a 1\nb 2\nd 3");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "line 3: text differs");
+
+    result = compare("a 1\nb 5\n", "a 1\nb 2\n");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "line 2: number 5 differs from the recorded 2 beyond the "
+              "tolerance");
+
+    EXPECT_FALSE(compare("a 1", "a 1 "));
+    EXPECT_FALSE(compare("test1", "test2"));
+}
+
+TEST(numeric_comparator, out_of_range)
+{
+    EXPECT_FALSE(datarecorder::parse_number("1e400").has_value());
+    EXPECT_EQ(datarecorder::parse_number("+2.5"), 2.5);
+
+    // Numbers a double cannot hold are compared as text
+    datarecorder::tolerance tolerance;
+    tolerance.relative = 1.0;
+    auto compare = datarecorder::numeric_comparator(tolerance);
+    EXPECT_TRUE(compare("x 1e400", "x 1e400"));
+    EXPECT_FALSE(compare("x 1e400", "x 2e400"));
+    EXPECT_FALSE(compare("x 1e400", "x 1"));
+}
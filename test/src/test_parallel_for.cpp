@@ -0,0 +1,36 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/parallel_for.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+TEST(parallel_for, visits_every_index_once)
+{
+    std::vector<int> visits(1000, 0);
+    datarecorder::parallel_for(visits.size(), 4,
+                               [&visits](std::size_t i) { ++visits[i]; });
+    EXPECT_EQ(visits, std::vector<int>(1000, 1));
+
+    // No work and more threads than work
+    datarecorder::parallel_for(0, 0, [](std::size_t) { FAIL(); });
+    datarecorder::parallel_for(1, 8, [&visits](std::size_t i) { --visits[i]; });
+    EXPECT_EQ(visits[0], 0);
+}
+
+TEST(parallel_for, rethrows)
+{
+    EXPECT_THROW(datarecorder::parallel_for(
+                     100, 4,
+                     [](std::size_t i)
+                     {
+                         if (i == 42)
+                         {
+                             throw std::runtime_error("failed");
+                         }
+                     }),
+                 std::runtime_error);
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/pattern.hpp>
+#include <gtest/gtest.h>
+
+TEST(pattern, literal)
+{
+    datarecorder::pattern pattern("abc");
+    EXPECT_EQ(pattern.match("abcd"), 3);
+    EXPECT_EQ(pattern.match("ab"), -1);
+    EXPECT_EQ(pattern.match("xabc"), -1);
+    EXPECT_TRUE(pattern.can_start_with('a'));
+    EXPECT_FALSE(pattern.can_start_with('b'));
+}
+
+TEST(pattern, quantifiers)
+{
+    EXPECT_EQ(datarecorder::pattern("a+").match("aaab"), 3);
+    EXPECT_EQ(datarecorder::pattern("ba*").match("b"), 1);
+    EXPECT_EQ(datarecorder::pattern("ba*c").match("baaac"), 5);
+    EXPECT_EQ(datarecorder::pattern("colou?r").match("color"), 5);
+    EXPECT_EQ(datarecorder::pattern("colou?r").match("colour"), 6);
+
+    // No backtracking is needed to find the longest match
+    EXPECT_EQ(datarecorder::pattern("\\d+5").match("12355x"), 5);
+    EXPECT_EQ(datarecorder::pattern(".*x").match("axbxc"), 4);
+}
+
+TEST(pattern, classes)
+{
+    datarecorder::pattern address("0x[0-9a-f]+");
+    EXPECT_EQ(address.match("0x7ffe12 "), 8);
+    EXPECT_EQ(address.match("0xz"), -1);
+
+    datarecorder::pattern template_literal("\\$\\{[^}]+\\}");
+    EXPECT_EQ(template_literal.match("${name} rest"), 7);
+    EXPECT_EQ(template_literal.match("${}"), -1);
+
+    EXPECT_EQ(datarecorder::pattern("\\w+\\s\\d").match("pid_1 4"), 7);
+    EXPECT_EQ(datarecorder::pattern("\\S+").match("abc def"), 3);
+    EXPECT_EQ(datarecorder::pattern(".+").match("ab\ncd"), 2);
+    EXPECT_EQ(datarecorder::pattern("[\\d.]+").match("1.25s"), 4);
+}
+
+TEST(pattern, matches_empty)
+{
+    EXPECT_TRUE(datarecorder::pattern("a*").matches_empty());
+    EXPECT_TRUE(datarecorder::pattern("a?b*").matches_empty());
+    EXPECT_FALSE(datarecorder::pattern("a?b").matches_empty());
+}
+
+TEST(pattern, compile_time)
+{
+    static constexpr datarecorder::pattern pattern("\\$\\{[^}]+\\}");
+    static_assert(pattern.match("${a}") == 4, "Matched at compile time");
+    static_assert(!pattern.matches_empty(), "Checked at compile time");
+
+    EXPECT_EQ(pattern.find("a ${} ${b} c").first, 6U);
+    EXPECT_EQ(pattern.find("a ${} ${b} c").second, 4U);
+    EXPECT_EQ(pattern.find("a ${} ${b} c", 7).first, std::string_view::npos);
+}
+
+TEST(pattern, find_without_single_first_character)
+{
+    datarecorder::pattern pattern("[0-9]+ms");
+    auto [position, length] = pattern.find("took 12s and 34ms");
+    EXPECT_EQ(position, 13U);
+    EXPECT_EQ(length, 4U);
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/recorder.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+TEST(recorder, record_string)
+{
+    datarecorder::recorder recorder;
+    recorder.set_recording_dir("test/recordings");
+    recorder.set_comparator(
+        [](std::string_view data, std::string_view recording)
+            -> tl::expected<void, std::string>
+        {
+            if (data != recording)
+            {
+                return tl::make_unexpected(std::string("data differs"));
+            }
+            return {};
+        });
+
+    EXPECT_TRUE(recorder.record("compiled recorder"));
+
+    datarecorder::recorder moved = std::move(recorder);
+    auto result = moved.record("compiled recorder!");
+    ASSERT_FALSE(result);
+    EXPECT_NE(result.error().find("data differs"), std::string::npos);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/recording_family.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+auto sweep(int changed) -> std::string
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+    {
+        data += "sample " + std::to_string(i) + ": " +
+                std::to_string(i == changed ? -1 : i * 3) + "\n";
+    }
+    return data;
+}
+}
+
+TEST(recording_family, delta_round_trip)
+{
+    std::string base = sweep(-1);
+    std::string variant = sweep(500) + "extra line";
+
+    std::string delta = datarecorder::encode_delta(base, variant);
+    EXPECT_LT(delta.size(), 100U);
+
+    auto target = datarecorder::apply_delta(base, delta);
+    ASSERT_TRUE(target);
+    EXPECT_EQ(*target, variant);
+
+    EXPECT_TRUE(datarecorder::compare_delta(variant, base, delta));
+
+    // Empty base and empty target
+    auto empty = datarecorder::apply_delta(
+        "", datarecorder::encode_delta("", "a\nb\n"));
+    ASSERT_TRUE(empty);
+    EXPECT_EQ(*empty, "a\nb\n");
+    EXPECT_TRUE(datarecorder::compare_delta(
+        "", base, datarecorder::encode_delta(base, "")));
+}
+
+TEST(recording_family, compare_delta)
+{
+    std::string base = sweep(-1);
+    std::string delta = datarecorder::encode_delta(base, sweep(500));
+
+    auto changed = datarecorder::compare_delta(sweep(700), base, delta);
+    ASSERT_FALSE(changed);
+    EXPECT_EQ(changed.error(),
+              "data differs from the recorded variant at line 501");
+
+    auto shorter = datarecorder::compare_delta("sample 0", base, delta);
+    ASSERT_FALSE(shorter);
+    EXPECT_EQ(shorter.error(),
+              "data differs from the recorded variant at line 1");
+
+    auto longer = datarecorder::compare_delta(sweep(500) + "x", base, delta);
+    ASSERT_FALSE(longer);
+    EXPECT_EQ(longer.error(),
+              "data differs from the recorded variant at line 1001");
+
+    auto other_base = datarecorder::compare_delta(sweep(500), sweep(1), delta);
+    ASSERT_FALSE(other_base);
+    EXPECT_EQ(other_base.error(),
+              "the delta was made against a different base");
+
+    auto corrupt = datarecorder::compare_delta(
+        sweep(500), base, delta.substr(0, delta.size() - 1));
+    ASSERT_FALSE(corrupt);
+    EXPECT_EQ(corrupt.error(), "not a valid delta");
+}
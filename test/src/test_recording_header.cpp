@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/array_recording.hpp>
+#include <datarecorder/binary_format.hpp>
+#include <datarecorder/check_recording.hpp>
+#include <datarecorder/recording_header.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(recording_header, round_trip)
+{
+    std::string payload = "recorded output\n";
+    auto header = datarecorder::make_recording_header(payload);
+    EXPECT_EQ(header.format, datarecorder::recording_format::raw);
+    EXPECT_EQ(header.payload_size, payload.size());
+
+    std::string data;
+    datarecorder::append_recording_header(data, header);
+    EXPECT_EQ(data.size(), datarecorder::recording_header_size);
+    EXPECT_EQ(data.substr(0, 4), "DRH1");
+    data += payload;
+
+    EXPECT_TRUE(datarecorder::has_recording_header(data));
+    EXPECT_EQ(*datarecorder::verify_recording_header(data), payload);
+
+    // The header decodes from the prefix alone
+    auto decoded = datarecorder::decode_recording_header(
+        std::string_view(data).substr(0, datarecorder::recording_header_size));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->payload_size, header.payload_size);
+    EXPECT_EQ(decoded->payload_hash, header.payload_hash);
+
+    // Data without a header is returned as it is
+    EXPECT_FALSE(datarecorder::has_recording_header(payload));
+    EXPECT_EQ(*datarecorder::verify_recording_header(payload), payload);
+}
+
+TEST(recording_header, detect_format)
+{
+    std::vector<double> values = {1.0, 2.0};
+    std::string array =
+        datarecorder::encode_array(values.data(), values.size());
+    EXPECT_EQ(datarecorder::detect_format(array),
+              datarecorder::recording_format::array);
+    EXPECT_EQ(datarecorder::detect_format("DRT1"),
+              datarecorder::recording_format::table);
+    EXPECT_EQ(datarecorder::detect_format("DRE1"),
+              datarecorder::recording_format::event_log);
+    EXPECT_EQ(datarecorder::detect_format("DRD1"),
+              datarecorder::recording_format::delta);
+    EXPECT_EQ(datarecorder::detect_format("text"),
+              datarecorder::recording_format::raw);
+}
+
+TEST(recording_header, rejects_invalid)
+{
+    std::string payload = "recorded output\n";
+    std::string data;
+    datarecorder::append_recording_header(
+        data, datarecorder::make_recording_header(payload));
+    data += payload;
+
+    // Truncated payload and header
+    EXPECT_FALSE(datarecorder::verify_recording_header(
+        data.substr(0, data.size() - 1)));
+    EXPECT_FALSE(datarecorder::decode_recording_header(data.substr(0, 20)));
+
+    // Changed payload
+    std::string changed = data;
+    changed.back() = '!';
+    EXPECT_FALSE(datarecorder::verify_recording_header(changed));
+
+    // A newer version, an unknown format and unknown flags
+    std::string newer = data;
+    newer[4] = 2;
+    EXPECT_FALSE(datarecorder::decode_recording_header(newer));
+    std::string format = data;
+    format[8] = 9;
+    EXPECT_FALSE(datarecorder::decode_recording_header(format));
+    std::string flags = data;
+    flags[12] = 1;
+    EXPECT_FALSE(datarecorder::decode_recording_header(flags));
+}
+
+TEST(recording_header, check_recording)
+{
+    std::vector<double> values = {1.0, 2.0};
+    std::string array =
+        datarecorder::encode_array(values.data(), values.size());
+
+    std::string data;
+    datarecorder::append_recording_header(
+        data, datarecorder::make_recording_header(array));
+    data += array;
+    EXPECT_TRUE(datarecorder::check_recording(data));
+
+    // A header announcing another format than the payload has
+    std::string mislabeled;
+    auto header = datarecorder::make_recording_header(array);
+    header.format = datarecorder::recording_format::raw;
+    datarecorder::append_recording_header(mislabeled, header);
+    mislabeled += array;
+    EXPECT_FALSE(datarecorder::check_recording(mislabeled));
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/scoped_arena.hpp>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <thread>
+
+TEST(scoped_arena, nesting)
+{
+    EXPECT_EQ(datarecorder::scoped_arena::current(), nullptr);
+    {
+        datarecorder::scoped_arena outer;
+        EXPECT_EQ(datarecorder::scoped_arena::current(), outer.resource());
+        {
+            datarecorder::scoped_arena inner(1024);
+            EXPECT_EQ(datarecorder::scoped_arena::current(), inner.resource());
+
+            // Arenas are per thread
+            std::thread thread(
+                [] {
+                    EXPECT_EQ(datarecorder::scoped_arena::current(), nullptr);
+                });
+            thread.join();
+        }
+        EXPECT_EQ(datarecorder::scoped_arena::current(), outer.resource());
+    }
+    EXPECT_EQ(datarecorder::scoped_arena::current(), nullptr);
+}
+
+TEST(scoped_arena, buffer)
+{
+    alignas(std::max_align_t) std::byte buffer[256];
+    datarecorder::scoped_arena arena(buffer, sizeof(buffer),
+                                     std::pmr::null_memory_resource());
+
+    // Allocations are served from the buffer until it is exhausted
+    std::pmr::string small(100, 'a', arena.resource());
+    EXPECT_GE(static_cast<const void*>(small.data()),
+              static_cast<const void*>(buffer));
+    EXPECT_LT(static_cast<const void*>(small.data()),
+              static_cast<const void*>(buffer + sizeof(buffer)));
+
+    EXPECT_THROW(std::pmr::string(1000, 'b', arena.resource()),
+                 std::bad_alloc);
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/session.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "temp_dir.hpp"
+
+TEST(session, writes_index_and_bundle_on_flush)
+{
+    datarecorder_test::temp_dir temp("session_flush");
+    const std::filesystem::path& dir = temp.path();
+    std::filesystem::path hunks_file;
+
+    {
+        datarecorder::session session(dir);
+
+        datarecorder::mismatch_info mismatch;
+        mismatch.recording_data = "hello\nworld\n";
+        mismatch.mismatch_data = "hello\nthere\n";
+        mismatch.recording_path = "recordings/session_test.data";
+
+        auto mismatch_path = session.add(mismatch);
+        EXPECT_EQ(datarecorder::read_file(mismatch_path), "hello\nthere\n");
+        EXPECT_EQ(session.size(), 1U);
+
+        // The hunks are written as they arrive, the index on the flush
+        hunks_file = mismatch_path.string() + ".hunks.js";
+        std::string hunks = datarecorder::read_file(hunks_file);
+        EXPECT_NE(hunks.find("\"ops\": \" -+\""), std::string::npos);
+        EXPECT_FALSE(std::filesystem::exists(session.index_path()));
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(dir / "index.html"));
+
+    std::string bundle = datarecorder::read_file(dir / "mismatches.js");
+    EXPECT_NE(bundle.find("\"name\": \"session_test.data\""),
+              std::string::npos);
+    EXPECT_NE(bundle.find("\"hunk_count\": 1, \"hunks_file\": \"" +
+                          hunks_file.filename().string() + "\""),
+              std::string::npos);
+}
+
+TEST(session, identical_mismatches_are_written_once)
+{
+    datarecorder_test::temp_dir temp("session_duplicates");
+    const std::filesystem::path& dir = temp.path();
+
+    {
+        datarecorder::session session(dir);
+
+        datarecorder::mismatch_info mismatch;
+        mismatch.recording_data = "header v1\n";
+        mismatch.mismatch_data = "header v2\n";
+        mismatch.recording_path = "recordings/first.data";
+        auto first = session.add(mismatch);
+
+        mismatch.recording_path = "recordings/second.data";
+        auto second = session.add(mismatch);
+
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(session.size(), 1U);
+        EXPECT_FALSE(std::filesystem::exists(dir / "1-second.data"));
+    }
+
+    std::string bundle = datarecorder::read_file(dir / "mismatches.js");
+    EXPECT_NE(bundle.find("\"duplicates\": [\"recordings/second.data\"]"),
+              std::string::npos);
+}
+
+TEST(session, concurrent_identical_mismatches)
+{
+    datarecorder_test::temp_dir temp("session_concurrent");
+    const std::filesystem::path& dir = temp.path();
+
+    datarecorder::session session(dir);
+
+    datarecorder::mismatch_info mismatch;
+    mismatch.recording_data = "a\n";
+    mismatch.mismatch_data = "b\n";
+
+    // Exactly one of the threads writes the mismatch
+    std::vector<std::thread> threads;
+    std::vector<std::filesystem::path> paths(8);
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        threads.emplace_back(
+            [&session, &paths, mismatch, i]() mutable
+            {
+                mismatch.recording_path =
+                    "recordings/" + std::to_string(i) + ".data";
+                paths[i] = session.add(mismatch);
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(session.size(), 1U);
+    for (const auto& path : paths)
+    {
+        EXPECT_EQ(path, paths[0]);
+    }
+
+    // The produced data and its hunks
+    std::size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+    {
+        files += entry.is_regular_file();
+    }
+    EXPECT_EQ(files, 2U);
+}
+
+TEST(session, shared_session_dir)
+{
+    datarecorder_test::temp_dir temp("session_shared");
+    const std::filesystem::path& dir = temp.path();
+
+    // Two sessions in the same directory, like two shards of a test binary
+    {
+        datarecorder::session first(dir);
+        datarecorder::session second(dir);
+
+        datarecorder::mismatch_info mismatch;
+        mismatch.recording_data = "a\n";
+        mismatch.mismatch_data = "b\n";
+        mismatch.recording_path = "recordings/first.data";
+        auto first_path = first.add(mismatch);
+
+        mismatch.recording_path = "recordings/second.data";
+        auto second_path = second.add(mismatch);
+
+        EXPECT_NE(first_path, second_path);
+        EXPECT_EQ(datarecorder::read_file(first_path), "b\n");
+        EXPECT_EQ(datarecorder::read_file(second_path), "b\n");
+    }
+
+    std::string bundle = datarecorder::read_file(dir / "mismatches.js");
+    EXPECT_NE(bundle.find("\"name\": \"first.data\""), std::string::npos);
+    EXPECT_NE(bundle.find("\"name\": \"second.data\""), std::string::npos);
+}
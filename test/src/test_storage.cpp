@@ -0,0 +1,99 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/storage.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "temp_dir.hpp"
+
+namespace
+{
+auto file_count(const std::filesystem::path& dir) -> std::size_t
+{
+    std::size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+    {
+        count += entry.is_regular_file();
+    }
+    return count;
+}
+}
+
+TEST(storage, create_file_exclusive)
+{
+    datarecorder_test::temp_dir temp("exclusive");
+    const std::filesystem::path& dir = temp.path();
+
+    EXPECT_TRUE(datarecorder::create_file_exclusive(dir / "a.data", "first"));
+    EXPECT_FALSE(
+        datarecorder::create_file_exclusive(dir / "a.data", "second"));
+    EXPECT_EQ(datarecorder::read_file(dir / "a.data"), "first");
+
+    // Of concurrent writers exactly one creates the file
+    std::vector<std::thread> threads;
+    std::vector<int> created(8, 0);
+    for (std::size_t i = 0; i < created.size(); ++i)
+    {
+        threads.emplace_back(
+            [&dir, &created, i]
+            {
+                created[i] = datarecorder::create_file_exclusive(
+                    dir / "b.data", "writer " + std::to_string(i));
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    int creators = 0;
+    for (std::size_t i = 0; i < created.size(); ++i)
+    {
+        if (created[i])
+        {
+            ++creators;
+            EXPECT_EQ(datarecorder::read_file(dir / "b.data"),
+                      "writer " + std::to_string(i));
+        }
+    }
+    EXPECT_EQ(creators, 1);
+
+    // No temporary files are left behind
+    EXPECT_EQ(file_count(dir), 2U);
+}
+
+TEST(storage, write_and_append)
+{
+    datarecorder_test::temp_dir temp("atomic");
+    const std::filesystem::path& dir = temp.path();
+
+    datarecorder::write_file_atomic(dir / "a.data", "old");
+    datarecorder::write_file_atomic(dir / "a.data", "new");
+    EXPECT_EQ(datarecorder::read_file(dir / "a.data"), "new");
+
+    datarecorder::append_file(dir / "b.data", "one\n");
+    datarecorder::append_file(dir / "b.data", "two\n");
+    EXPECT_EQ(datarecorder::read_file(dir / "b.data"), "one\ntwo\n");
+
+    EXPECT_EQ(file_count(dir), 2U);
+}
+
+TEST(storage, create_mismatch_dir)
+{
+    std::filesystem::path taken = datarecorder::create_mismatch_dir();
+    EXPECT_TRUE(std::filesystem::is_directory(taken));
+
+    // A directory taken in the meantime is skipped
+    std::filesystem::path mismatch_dir =
+        datarecorder::create_mismatch_dir(taken);
+    EXPECT_NE(mismatch_dir, taken);
+    EXPECT_TRUE(std::filesystem::is_directory(mismatch_dir));
+
+    std::filesystem::remove_all(taken);
+    std::filesystem::remove_all(mismatch_dir);
+}
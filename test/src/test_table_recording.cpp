@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <datarecorder/table_recording.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+auto flow_schema() -> datarecorder::table_schema
+{
+    datarecorder::tolerance rate_tolerance;
+    rate_tolerance.absolute = 0.01;
+
+    datarecorder::table_schema schema;
+    schema.add_column("flow", datarecorder::column_type::integer)
+        .add_column("protocol", datarecorder::column_type::text)
+        .add_column("rate", datarecorder::column_type::floating_point,
+                    rate_tolerance);
+    return schema;
+}
+}
+
+TEST(table_recording, encode_decode)
+{
+    datarecorder::table table(flow_schema());
+    table.add_row(1, "tcp", 12.5);
+    table.add_row(2, "udp", 3);
+
+    auto view = datarecorder::decode_table(datarecorder::encode_table(table));
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view->rows, 2U);
+    ASSERT_EQ(view->columns.size(), 3U);
+    EXPECT_EQ(view->columns[1].name, "protocol");
+    EXPECT_EQ(view->columns[1].text_at(0), "tcp");
+    EXPECT_EQ(view->columns[1].text_at(1), "udp");
+    EXPECT_EQ(table.floats(2)[1], 3.0);
+
+    std::string encoded = datarecorder::encode_table(table);
+    EXPECT_FALSE(datarecorder::decode_table(
+        encoded.substr(0, encoded.size() - 1)));
+    EXPECT_FALSE(datarecorder::decode_table("DRT1"));
+}
+
+TEST(table_recording, compare)
+{
+    datarecorder::table recorded(flow_schema());
+    datarecorder::table produced(flow_schema());
+    for (int flow = 0; flow < 100; ++flow)
+    {
+        recorded.add_row(flow, "tcp", flow * 0.5);
+        produced.add_row(flow, flow == 42 ? "udp" : "tcp",
+                         flow * 0.5 + (flow >= 90 ? 1.0 : 0.001));
+    }
+
+    auto compare = datarecorder::table_comparator(flow_schema());
+    std::string recording = datarecorder::encode_table(recorded);
+
+    EXPECT_TRUE(compare(recording, recording));
+
+    auto result = compare(datarecorder::encode_table(produced), recording);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "(row 42, column \"protocol\") is \"udp\", the recording has "
+              "\"tcp\"; 1 differing cell(s) in the column\n"
+              "(row 90, column \"rate\") is 46, the recording has 45; 10 "
+              "differing cell(s) in the column");
+
+    datarecorder::table_schema other;
+    other.add_column("flow", datarecorder::column_type::floating_point);
+    datarecorder::table other_table(other);
+    for (int flow = 0; flow < 100; ++flow)
+    {
+        other_table.add_row(flow);
+    }
+    auto columns = compare(datarecorder::encode_table(other_table), recording);
+    ASSERT_FALSE(columns);
+    EXPECT_EQ(columns.error(),
+              "column \"protocol\" is missing\n"
+              "column \"rate\" is missing\n"
+              "column \"flow\" has type floating_point, the recording has "
+              "integer");
+}
+
+TEST(table_recording, large_integers)
+{
+    // Timestamps above 2^53 that differ by one are equal as doubles
+    datarecorder::table_schema schema;
+    schema.add_column("timestamp", datarecorder::column_type::integer);
+
+    datarecorder::table recorded(schema);
+    datarecorder::table produced(schema);
+    recorded.add_row(std::int64_t{1700000000000000000});
+    produced.add_row(std::int64_t{1700000000000000001});
+
+    auto compare = datarecorder::table_comparator(schema);
+    auto result = compare(datarecorder::encode_table(produced),
+                          datarecorder::encode_table(recorded));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "(row 0, column \"timestamp\") is 1700000000000000001, the "
+              "recording has 1700000000000000000; 1 differing cell(s) in the "
+              "column");
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/unordered_lines_comparator.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(unordered_lines_comparator, for_each_line)
+{
+    std::vector<std::string> lines;
+    datarecorder::for_each_line("a\n\nb\nc", [&lines](std::string_view line)
+                                { lines.emplace_back(line); });
+    EXPECT_EQ(lines, (std::vector<std::string>{"a", "", "b", "c"}));
+
+    lines.clear();
+    datarecorder::for_each_line("a\n", [&lines](std::string_view line)
+                                { lines.emplace_back(line); });
+    EXPECT_EQ(lines, (std::vector<std::string>{"a"}));
+}
+
+TEST(unordered_lines_comparator, compare)
+{
+    auto compare = datarecorder::unordered_lines_comparator();
+
+    EXPECT_TRUE(compare("thread 1\nthread 2\nthread 1\n",
+                        "thread 1\nthread 1\nthread 2\n"));
+
+    auto result = compare("thread 2\nthread 3\nthread 3\nthread 1\n",
+                          "thread 1\nthread 2\nthread 4\n");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "2 surplus line(s) not in the recording:\n"
+              "  \"thread 3\" (2 times)\n"
+              "1 line(s) missing from the recording:\n"
+              "  \"thread 4\"");
+
+    // A line that appears too often
+    auto counts = compare("a\na\nb\n", "a\nb\n");
+    ASSERT_FALSE(counts);
+    EXPECT_EQ(counts.error(), "1 surplus line(s) not in the recording:\n"
+                              "  \"a\"");
+}
+
+TEST(unordered_lines_comparator, max_lines)
+{
+    auto compare = datarecorder::unordered_lines_comparator(2);
+
+    auto result = compare("1\n2\n3\n4\n", "");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "4 surplus line(s) not in the recording:\n"
+                              "  \"1\"\n  \"2\"\n  ... 2 more");
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/usage_journal.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "temp_dir.hpp"
+
+TEST(usage_journal, format_parse)
+{
+    datarecorder::journal_entry entry;
+    entry.test = "suite_test";
+    entry.recording = "dir/suite test.data";
+    entry.hash = 0x0123456789abcdef;
+
+    std::string line = datarecorder::format_journal_entry(entry);
+    EXPECT_EQ(line, "suite_test\tdir/suite test.data\t0123456789abcdef\n");
+
+    auto journal = datarecorder::parse_journal(line + "\n" + line);
+    ASSERT_TRUE(journal);
+    ASSERT_EQ(journal->size(), 2U);
+    EXPECT_EQ((*journal)[1].test, entry.test);
+    EXPECT_EQ((*journal)[1].recording, entry.recording);
+    EXPECT_EQ((*journal)[1].hash, entry.hash);
+
+    EXPECT_FALSE(datarecorder::parse_journal("test\t0123456789abcdef\n"));
+    EXPECT_FALSE(datarecorder::parse_journal("test\ta.data\t0123\n"));
+    EXPECT_FALSE(datarecorder::parse_journal("t\ta\t0123456789abcdeg\n"));
+}
+
+TEST(usage_journal, orphans_and_affected_tests)
+{
+    std::vector<datarecorder::journal_entry> journal = {
+        {"first", "a.data", 1}, {"second", "a.data", 1},
+        {"second", "b.data", 2}, {"third", "c.data", 3},
+        {"third", "c.data", 4}, {"", "d.data", 5}};
+
+    std::vector<datarecorder::manifest_entry> manifest = {
+        {"a.data", 1, 1}, {"b.data", 1, 7}, {"c.data", 1, 4},
+        {"d.data", 1, 6}, {"e.data", 1, 8}};
+
+    EXPECT_EQ(datarecorder::orphaned_recordings(
+                  {"e.data", "a.data", "f.data", "b.data"}, journal),
+              (std::vector<std::string>{"e.data", "f.data"}));
+
+    // b.data changed, the last use of c.data matches and tests with no name
+    // are not reported
+    EXPECT_EQ(datarecorder::affected_tests(journal, manifest),
+              std::vector<std::string>{"second"});
+
+    // A removed recording affects every test that used it
+    manifest.erase(manifest.begin());
+    EXPECT_EQ(datarecorder::affected_tests(journal, manifest),
+              (std::vector<std::string>{"first", "second"}));
+}
+
+TEST(usage_journal, append)
+{
+    datarecorder_test::temp_dir temp("usage_journal_append");
+    std::filesystem::path path = temp.path() / "usage.journal";
+
+    // Journals opened after each other append to the same file
+    for (int run = 0; run < 2; ++run)
+    {
+        datarecorder::usage_journal journal(path);
+        journal.add({"test", "a.data", 1});
+    }
+
+    auto journal = datarecorder::parse_journal(datarecorder::read_file(path));
+    ASSERT_TRUE(journal);
+    EXPECT_EQ(journal->size(), 2U);
+}
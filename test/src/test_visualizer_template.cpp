@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/visualizer_template.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "temp_dir.hpp"
+
+namespace
+{
+auto fill(const datarecorder::visualizer_template& visualizer) -> std::string
+{
+    std::stringstream out;
+    visualizer.write(
+        out,
+        [](std::ostream& out, datarecorder::visualizer_template::slot slot)
+        {
+            out << (slot == datarecorder::visualizer_template::slot::
+                                recording_data
+                        ? "old $1"
+                        : "new $&");
+        });
+    return out.str();
+}
+}
+
+TEST(visualizer_template, fill_slots)
+{
+    datarecorder::visualizer_template visualizer(
+        "<script>\nconst newText = `x`;\nconst   oldText = `y`;\n</script>");
+    EXPECT_EQ(visualizer.slots(), 2U);
+
+    // The data is inserted as is, also when it looks like a regex
+    // substitution
+    EXPECT_EQ(fill(visualizer), "<script>\nconst newText = `new $&`;\nconst   "
+                                "oldText = `old $1`;\n</script>");
+}
+
+TEST(visualizer_template, no_slots)
+{
+    datarecorder::visualizer_template visualizer("<html></html>");
+    EXPECT_EQ(visualizer.slots(), 0U);
+    EXPECT_EQ(fill(visualizer), "<html></html>");
+}
+
+TEST(visualizer_template, load_is_cached)
+{
+    datarecorder_test::temp_dir temp("visualizer_template");
+    std::filesystem::path path = temp.path() / "recording_diff.html";
+    datarecorder::write_file(path, "const oldText = ``;");
+
+    auto first = datarecorder::visualizer_template::load(path);
+    datarecorder::write_file(path, "changed");
+    auto second = datarecorder::visualizer_template::load(path);
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second->slots(), 1U);
+}
+
+TEST(visualizer_template, escape_dollar_bracs)
+{
+    std::stringstream out;
+    datarecorder::escape_dollar_bracs(out, "${a} $b ${} ${c}d");
+    EXPECT_EQ(out.str(), "\\${a} $b ${} \\${c}d");
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <datarecorder/whitespace_comparator.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(whitespace_comparator, defaults)
+{
+    auto compare = datarecorder::whitespace_comparator();
+
+    EXPECT_TRUE(compare("a\nb\n", "a\r\nb\r\n"));
+    EXPECT_TRUE(compare("a  \nb\t\n", "a\nb"));
+    EXPECT_TRUE(compare("a\nb", "a\nb\n"));
+
+    // Leading whitespace is significant
+    auto result = compare("a\n b\n", "a\r\nb\r\n");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "line 2 is \" b\", the recording has \"b\"");
+
+    auto longer = compare("a\nb\nc\n", "a\r\nb\r\n");
+    ASSERT_FALSE(longer);
+    EXPECT_EQ(longer.error(), "line 3 \"c\" is not in the recording");
+
+    auto shorter = compare("a\n", "a\r\nb\r\n");
+    ASSERT_FALSE(shorter);
+    EXPECT_EQ(shorter.error(), "line 2 \"b\" of the recording is missing");
+}
+
+TEST(whitespace_comparator, options)
+{
+    datarecorder::whitespace_options options;
+    options.ignore_trailing_whitespace = false;
+    options.ignore_final_newline = false;
+    auto compare = datarecorder::whitespace_comparator(options);
+
+    EXPECT_TRUE(compare("a\nb\n", "a\r\nb\r\n"));
+    EXPECT_FALSE(compare("a \n", "a\n"));
+
+    auto result = compare("a\nb", "a\nb\n");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(),
+              "recording ends with a newline, the data does not");
+}
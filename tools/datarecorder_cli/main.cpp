@@ -0,0 +1,443 @@
+// Copyright (c) 2025 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <datarecorder/accept_mismatch.hpp>
+#include <datarecorder/archive.hpp>
+#include <datarecorder/check_recording.hpp>
+#include <datarecorder/diff.hpp>
+#include <datarecorder/manifest.hpp>
+#include <datarecorder/parallel_for.hpp>
+#include <datarecorder/storage.hpp>
+#include <datarecorder/usage_journal.hpp>
+
+namespace
+{
+
+const char* usage_text = R"(usage: datarecorder <command> [options] <arguments>
+
+commands:
+  verify <recording_dir> [--manifest FILE] [--write-manifest FILE]
+      Check the structure of every recording and compare their hashes with
+      a manifest.
+  diff <mismatch_dir> <recording_dir>
+      Print the differences between the mismatches of a mismatch directory
+      or session and the recordings.
+  pack <recording_dir> <archive>
+      Pack the recordings into a single archive.
+  unpack <archive> <recording_dir>
+      Unpack an archive into the recording directory.
+  stats <recording_dir> [--top N]
+      Print a size histogram and the largest recordings.
+  accept <mismatch_dir> <recording_dir>
+      Replace the recordings with the mismatches, encoded like the
+      recordings they replace.
+  orphans <recording_dir> <journal>
+      Print the recordings no test in the usage journal used.
+  affected <recording_dir> <journal>
+      Print the tests in the usage journal that used a recording which has
+      changed or was removed since.
+
+options:
+  --threads N    The number of threads, default is the number of cores
+)";
+
+struct options
+{
+    std::string command;
+    std::vector<std::string> arguments;
+    std::size_t threads = 0;
+    std::size_t top = 10;
+    std::optional<std::string> manifest;
+    std::optional<std::string> write_manifest;
+};
+
+auto parse_options(int argc, char** argv) -> std::optional<options>
+{
+    if (argc < 2)
+    {
+        return std::nullopt;
+    }
+
+    options result;
+    result.command = argv[1];
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool has_value = i + 1 < argc;
+        if (argument == "--threads" && has_value)
+        {
+            result.threads = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (argument == "--top" && has_value)
+        {
+            result.top = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (argument == "--manifest" && has_value)
+        {
+            result.manifest = argv[++i];
+        }
+        else if (argument == "--write-manifest" && has_value)
+        {
+            result.write_manifest = argv[++i];
+        }
+        else if (argument.rfind("--", 0) == 0)
+        {
+            return std::nullopt;
+        }
+        else
+        {
+            result.arguments.push_back(argument);
+        }
+    }
+    return result;
+}
+
+auto verify(const options& options) -> int
+{
+    std::filesystem::path dir = options.arguments.at(0);
+
+    std::vector<std::string> paths = datarecorder::list_recordings(dir);
+    std::vector<datarecorder::manifest_entry> manifest(paths.size());
+    std::vector<std::string> problems(paths.size());
+    datarecorder::parallel_for(
+        paths.size(), options.threads,
+        [&](std::size_t i)
+        {
+            std::string data = datarecorder::read_binary_file(dir / paths[i]);
+            manifest[i].path = paths[i];
+            manifest[i].size = data.size();
+            manifest[i].hash = datarecorder::fnv1a_64(data);
+
+            auto check = datarecorder::check_recording(data);
+            if (!check)
+            {
+                problems[i] = "invalid: " + paths[i] + ": " + check.error();
+            }
+        });
+
+    problems.erase(std::remove(problems.begin(), problems.end(), ""),
+                   problems.end());
+
+    if (options.manifest)
+    {
+        auto expected = datarecorder::parse_manifest(
+            datarecorder::read_file(*options.manifest));
+        if (!expected)
+        {
+            std::cerr << *options.manifest << ": " << expected.error()
+                      << std::endl;
+            return 1;
+        }
+        for (auto& problem :
+             datarecorder::compare_manifests(*expected, manifest))
+        {
+            problems.push_back(std::move(problem));
+        }
+    }
+
+    if (options.write_manifest)
+    {
+        datarecorder::write_file(*options.write_manifest,
+                                 datarecorder::format_manifest(manifest));
+    }
+
+    for (const auto& problem : problems)
+    {
+        std::cout << problem << "\n";
+    }
+    std::cout << paths.size() << " recording(s), " << problems.size()
+              << " problem(s)" << std::endl;
+    return problems.empty() ? 0 : 1;
+}
+
+/// Return the recording a file in a mismatch directory belongs to. Files in
+/// a session are prefixed with "<token>-<N>-".
+auto recording_for(const std::filesystem::path& mismatch,
+                   const std::filesystem::path& recording_dir)
+    -> std::optional<std::filesystem::path>
+{
+    std::string name = mismatch.filename().string();
+    while (true)
+    {
+        if (std::filesystem::is_regular_file(recording_dir / name))
+        {
+            return recording_dir / name;
+        }
+
+        std::size_t dash = name.find('-');
+        if (dash == std::string::npos || dash == 0 ||
+            !std::all_of(name.begin(), name.begin() + dash,
+                         [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            return std::nullopt;
+        }
+        name.erase(0, dash + 1);
+    }
+}
+
+/// The mismatches of a mismatch directory with their recordings
+auto find_mismatches(const std::filesystem::path& mismatch_dir,
+                     const std::filesystem::path& recording_dir)
+    -> std::vector<std::pair<std::filesystem::path, std::filesystem::path>>
+{
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>>
+        mismatches;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(mismatch_dir))
+    {
+        if (!entry.is_regular_file())
+        {
+            continue;
+        }
+        if (auto recording = recording_for(entry.path(), recording_dir))
+        {
+            mismatches.emplace_back(entry.path(), *recording);
+        }
+    }
+    std::sort(mismatches.begin(), mismatches.end());
+    return mismatches;
+}
+
+auto diff(const options& options) -> int
+{
+    auto mismatches =
+        find_mismatches(options.arguments.at(0), options.arguments.at(1));
+
+    // Compute the diffs in parallel and print them in order
+    std::vector<std::string> outputs(mismatches.size());
+    datarecorder::parallel_for(
+        mismatches.size(), options.threads,
+        [&](std::size_t i)
+        {
+            const auto& [mismatch_path, recording_path] = mismatches[i];
+            auto hunks = datarecorder::diff_lines(
+                datarecorder::read_file(recording_path),
+                datarecorder::read_file(mismatch_path));
+            if (hunks.empty())
+            {
+                return;
+            }
+
+            std::string& output = outputs[i];
+            output += "--- " + recording_path.string() + "\n";
+            output += "+++ " + mismatch_path.string() + "\n";
+            for (const auto& hunk : hunks)
+            {
+                output += datarecorder::hunk_header(hunk) + "\n";
+                for (const auto& line : hunk.lines)
+                {
+                    output += line.op + line.text + "\n";
+                }
+            }
+        });
+
+    std::size_t differing = 0;
+    for (const auto& output : outputs)
+    {
+        differing += !output.empty();
+        std::cout << output;
+    }
+    std::cout << mismatches.size() << " mismatch(es), " << differing
+              << " differ from their recording" << std::endl;
+    return differing == 0 ? 0 : 1;
+}
+
+auto pack(const options& options) -> int
+{
+    std::string archive =
+        datarecorder::pack(options.arguments.at(0), options.threads);
+    datarecorder::write_binary_file(options.arguments.at(1), archive);
+    return 0;
+}
+
+auto unpack(const options& options) -> int
+{
+    auto files = datarecorder::unpack(
+        datarecorder::read_binary_file(options.arguments.at(0)),
+        options.arguments.at(1));
+    if (!files)
+    {
+        std::cerr << options.arguments.at(0) << ": " << files.error()
+                  << std::endl;
+        return 1;
+    }
+    std::cout << *files << " recording(s) unpacked" << std::endl;
+    return 0;
+}
+
+auto stats(const options& options) -> int
+{
+    std::filesystem::path dir = options.arguments.at(0);
+    std::vector<std::string> paths = datarecorder::list_recordings(dir);
+    std::vector<std::uintmax_t> sizes(paths.size());
+    datarecorder::parallel_for(paths.size(), options.threads,
+                               [&](std::size_t i)
+                               { sizes[i] = file_size(dir / paths[i]); });
+
+    // Histogram with power of two buckets
+    std::vector<std::size_t> buckets(65, 0);
+    std::uintmax_t total = 0;
+    for (auto size : sizes)
+    {
+        std::size_t bucket = 0;
+        while (bucket < 64 && (std::uintmax_t{1} << bucket) <= size)
+        {
+            ++bucket;
+        }
+        ++buckets[bucket];
+        total += size;
+    }
+
+    std::cout << paths.size() << " recording(s), " << total << " bytes\n";
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+    {
+        if (buckets[bucket] == 0)
+        {
+            continue;
+        }
+        std::uintmax_t low =
+            bucket == 0 ? 0 : std::uintmax_t{1} << (bucket - 1);
+        std::cout << "  >= " << low << " bytes: " << buckets[bucket] << "\n";
+    }
+
+    std::vector<std::size_t> order(paths.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::size_t top = std::min(options.top, order.size());
+    std::partial_sort(order.begin(), order.begin() + top, order.end(),
+                      [&sizes](std::size_t a, std::size_t b)
+                      { return sizes[a] > sizes[b]; });
+
+    std::cout << "largest:\n";
+    for (std::size_t i = 0; i < top; ++i)
+    {
+        std::cout << "  " << sizes[order[i]] << " " << paths[order[i]] << "\n";
+    }
+    std::cout << std::flush;
+    return 0;
+}
+
+auto accept(const options& options) -> int
+{
+    auto mismatches =
+        find_mismatches(options.arguments.at(0), options.arguments.at(1));
+    std::size_t accepted = 0;
+    for (const auto& [mismatch_path, recording_path] : mismatches)
+    {
+        auto result = datarecorder::accept_mismatch(mismatch_path,
+                                                    recording_path);
+        if (!result)
+        {
+            std::cerr << recording_path.string() << ": " << result.error()
+                      << std::endl;
+            continue;
+        }
+        ++accepted;
+        std::cout << "accepted: " << recording_path.string() << "\n";
+    }
+    std::cout << accepted << " recording(s) accepted" << std::endl;
+    return accepted == mismatches.size() ? 0 : 1;
+}
+
+/// Read the usage journal, or print the error and return std::nullopt
+auto read_journal(const std::string& path)
+    -> std::optional<std::vector<datarecorder::journal_entry>>
+{
+    auto journal = datarecorder::parse_journal(datarecorder::read_file(path));
+    if (!journal)
+    {
+        std::cerr << path << ": " << journal.error() << std::endl;
+        return std::nullopt;
+    }
+    return std::move(*journal);
+}
+
+auto orphans(const options& options) -> int
+{
+    auto journal = read_journal(options.arguments.at(1));
+    if (!journal)
+    {
+        return 1;
+    }
+
+    auto orphans = datarecorder::orphaned_recordings(
+        datarecorder::list_recordings(options.arguments.at(0)), *journal);
+    for (const auto& orphan : orphans)
+    {
+        std::cout << orphan << "\n";
+    }
+    std::cout << std::flush;
+    return 0;
+}
+
+auto affected(const options& options) -> int
+{
+    auto journal = read_journal(options.arguments.at(1));
+    if (!journal)
+    {
+        return 1;
+    }
+
+    auto manifest =
+        datarecorder::make_manifest(options.arguments.at(0), options.threads);
+    for (const auto& test : datarecorder::affected_tests(*journal, manifest))
+    {
+        std::cout << test << "\n";
+    }
+    std::cout << std::flush;
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    auto options = parse_options(argc, argv);
+
+    struct command
+    {
+        const char* name;
+        std::size_t arguments;
+        int (*run)(const ::options&);
+    };
+    const command commands[] = {{"verify", 1, verify}, {"diff", 2, diff},
+                                {"pack", 2, pack},     {"unpack", 2, unpack},
+                                {"stats", 1, stats},   {"accept", 2, accept},
+                                {"orphans", 2, orphans},
+                                {"affected", 2, affected}};
+
+    for (const auto& c : commands)
+    {
+        if (options && options->command == c.name &&
+            options->arguments.size() == c.arguments)
+        {
+            try
+            {
+                return c.run(*options);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "datarecorder: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cerr << usage_text;
+    return 2;
+}
\ No newline at end of file